@@ -2,16 +2,27 @@
 #include <utility>      // std::move
 #include <exception>    // std::exception
 
+namespace {
+
+// Pool and index of the worker running on this thread
+thread_local const ThreadPool *current_pool = nullptr;
+thread_local size_t current_index = ThreadPool::NOT_A_WORKER;
+
+} // namespace
+
 // Start worker threads
 ThreadPool::ThreadPool(size_t numThreads) : stop(false) {
     workers.reserve(numThreads);
     for (size_t i = 0; i < numThreads; ++i) {
-        workers.emplace_back([this] { worker_loop(); });
+        workers.emplace_back([this, i] { worker_loop(i); });
     }
 }
 
 // Worker main loop: wait for work; exit when stop && tasks empty
-void ThreadPool::worker_loop() {
+void ThreadPool::worker_loop(size_t index) {
+    current_pool = this;
+    current_index = index;
+
     for (;;) {
         std::function<void()> task;
 
@@ -37,6 +48,10 @@ void ThreadPool::worker_loop() {
     }
 }
 
+size_t ThreadPool::currentWorkerIndex() const {
+    return current_pool == this ? current_index : NOT_A_WORKER;
+}
+
 // Stop pool and join all workers
 ThreadPool::~ThreadPool() {
     {
@@ -10,6 +10,7 @@
 #include <future>
 #include <stdexcept>
 #include <atomic>
+#include <cstddef>
 
 class ThreadPool {
 public:
@@ -17,6 +18,16 @@ public:
 
     ~ThreadPool();
 
+    // Number of worker threads
+    size_t size() const { return workers.size(); }
+
+    // Returned by currentWorkerIndex() on threads that are not workers of this pool
+    static constexpr size_t NOT_A_WORKER = static_cast<size_t>(-1);
+
+    // Index in [0, size()) of the calling thread if it is one of this pool's
+    // workers, otherwise NOT_A_WORKER. Lets tasks pick per-worker state.
+    size_t currentWorkerIndex() const;
+
     template<class F, class... Args>
     auto submit(F&& f, Args&&... args)
         -> std::future<std::invoke_result_t<F, Args...>>
@@ -56,7 +67,7 @@ private:
     std::condition_variable condition;
     std::atomic<bool> stop;
 
-    void worker_loop();
+    void worker_loop(size_t index);
 };
 
 #endif // THREADPOOL_H
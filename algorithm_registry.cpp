@@ -0,0 +1,65 @@
+#include "algorithm_registry.h"
+#include <iostream>
+#include <utility>
+
+AlgorithmRegistry &AlgorithmRegistry::instance() {
+    // Function-local static: safe to use from other translation units' static initialisers
+    static AlgorithmRegistry registry;
+    return registry;
+}
+
+bool AlgorithmRegistry::add(AlgorithmInfo info) {
+    if (findById(info.id)) {
+        std::cerr << "Error: Duplicate algorithm id " << info.id << std::endl;
+        return false;
+    }
+    algorithms_.push_back(std::move(info));
+    return true;
+}
+
+const std::vector<AlgorithmInfo> &AlgorithmRegistry::algorithms() const {
+    return algorithms_;
+}
+
+const AlgorithmInfo *AlgorithmRegistry::findById(const std::string &id) const {
+    for (const auto &info: algorithms_) {
+        if (info.id == id) {
+            return &info;
+        }
+    }
+    return nullptr;
+}
+
+const AlgorithmInfo *AlgorithmRegistry::findByName(const std::string &name) const {
+    for (const auto &info: algorithms_) {
+        if (info.name == name) {
+            return &info;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<const AlgorithmInfo *> AlgorithmRegistry::matching(unsigned required_capabilities,
+                                                               KeyType key_type) const {
+    std::vector<const AlgorithmInfo *> result;
+    for (const auto &info: algorithms_) {
+        if (info.has(required_capabilities) && (info.key_types & key_type)) {
+            result.push_back(&info);
+        }
+    }
+    return result;
+}
+
+AlgorithmRegistrar::AlgorithmRegistrar(AlgorithmInfo info) {
+    AlgorithmRegistry::instance().add(std::move(info));
+}
+
+const char *extraMemoryName(ExtraMemory extra_memory) {
+    switch (extra_memory) {
+        case ExtraMemory::Constant: return "O(1)";
+        case ExtraMemory::Logarithmic: return "O(log n)";
+        case ExtraMemory::SquareRoot: return "O(sqrt n)";
+        case ExtraMemory::Linear: return "O(n)";
+    }
+    return "unknown";
+}
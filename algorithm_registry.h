@@ -0,0 +1,91 @@
+#ifndef ALGORITHM_REGISTRY_H
+#define ALGORITHM_REGISTRY_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+// A ready-to-run sort over the benchmark's input type
+using SortFunction = std::function<void(std::vector<int> &)>;
+
+// A ready-to-run segmented sort: sorts every [offsets[i], offsets[i + 1]) of the buffer
+using SegmentedSortFunction = std::function<void(std::vector<int> &, const std::vector<size_t> &)>;
+
+// Resources an algorithm may bind when it is instantiated
+struct SortEnvironment {
+    ThreadPool &pool;
+    int thread_count;
+    bool reuse_scratch = false;    // bind a SortContext, so repeated sorts reuse their scratch memory
+};
+
+// Capability flags (bitmask)
+enum SortCapability : unsigned {
+    CAP_STABLE = 1u << 0,
+    CAP_IN_PLACE = 1u << 1,
+    CAP_PARALLEL = 1u << 2,
+    CAP_NEEDS_THREADPOOL = 1u << 3,
+    CAP_SEGMENTED = 1u << 4       // sorts segmented buffers (segmented_factory) instead of whole arrays
+};
+
+// Key types an algorithm can sort (bitmask)
+enum KeyType : unsigned {
+    KEY_INT32 = 1u << 0,
+    KEY_INT64 = 1u << 1,
+    KEY_STRING = 1u << 2
+};
+
+// Asymptotic extra memory beyond the input array
+enum class ExtraMemory {
+    Constant,
+    Logarithmic,
+    SquareRoot,
+    Linear
+};
+
+struct AlgorithmInfo {
+    std::string id;                  // short command-line name, e.g. "merge-pool"
+    std::string name;                // display name used in reports
+    unsigned capabilities;           // SortCapability flags
+    unsigned key_types;              // KeyType flags
+    ExtraMemory extra_memory;
+    std::function<SortFunction(const SortEnvironment &)> factory;
+    std::string speedup_baseline;    // id of the algorithm this one reports a speedup against (empty = none)
+    std::function<SegmentedSortFunction(const SortEnvironment &)> segmented_factory = nullptr;
+
+    bool has(unsigned capability) const { return (capabilities & capability) == capability; }
+};
+
+// Process-wide list of sorting algorithms, filled at static-initialisation time
+class AlgorithmRegistry {
+public:
+    static AlgorithmRegistry &instance();
+
+    // Returns false (and ignores the entry) if the id is already taken
+    bool add(AlgorithmInfo info);
+
+    // All algorithms, in registration order
+    const std::vector<AlgorithmInfo> &algorithms() const;
+
+    const AlgorithmInfo *findById(const std::string &id) const;
+
+    const AlgorithmInfo *findByName(const std::string &name) const;
+
+    // Algorithms that have every requested capability and support the key type
+    std::vector<const AlgorithmInfo *> matching(unsigned required_capabilities, KeyType key_type) const;
+
+private:
+    AlgorithmRegistry() = default;
+
+    std::vector<AlgorithmInfo> algorithms_;
+};
+
+// Registers an algorithm when constructed; use as a namespace-scope static
+struct AlgorithmRegistrar {
+    explicit AlgorithmRegistrar(AlgorithmInfo info);
+};
+
+const char *extraMemoryName(ExtraMemory extra_memory);
+
+#endif // ALGORITHM_REGISTRY_H
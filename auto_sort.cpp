@@ -0,0 +1,384 @@
+#include "auto_sort.h"
+#include "benchmark.h"
+#include "ThreadPool.h"
+#include "timer.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <utility>
+
+namespace {
+
+// Positions sampled by sampleInput: about one in SAMPLE_STRIDE, within these bounds,
+// so sampling never costs a noticeable share of the sort
+constexpr size_t SAMPLE_SIZE = 1024;
+constexpr size_t MIN_SAMPLE_SIZE = 16;
+constexpr size_t SAMPLE_STRIDE = 16;
+
+// Classification thresholds on the sample
+constexpr double PRESORTED_DESCENTS = 0.1;
+constexpr double REVERSED_DESCENTS = 0.9;
+constexpr double FEW_UNIQUE_DUPLICATES = 0.5;
+constexpr uint64_t NARROW_KEY_RANGE = uint64_t(1) << 24;
+
+// Input sizes the calibration measures; lookups use the nearest on a log scale
+constexpr size_t CALIBRATION_SIZES[] = {1 << 8, 1 << 12, 1 << 16, 1 << 20};
+
+constexpr InputShape CALIBRATION_SHAPES[] = {
+    InputShape::Random, InputShape::NarrowRange, InputShape::Presorted, InputShape::Reversed, InputShape::FewUnique
+};
+
+// Small inputs are timed in batches of about this many elements
+constexpr size_t CALIBRATION_BATCH_ELEMENTS = 1 << 18;
+
+// Candidates this much slower than the best at one size are not timed at larger sizes
+constexpr double PRUNE_FACTOR = 4.0;
+
+// Not calibrated: auto itself, quick (O(n^2) time on presorted input) and
+// merge-threads (spawns threads on every call)
+constexpr const char *EXCLUDED_CANDIDATES[] = {"auto", "quick", "merge-threads"};
+
+// Used when the profile has nothing for an input
+constexpr const char *FALLBACK_ALGORITHM = "stl";
+
+constexpr const char *SHAPE_NAMES[] = {"random", "narrow-range", "presorted", "reversed", "few-unique"};
+
+bool excluded(const std::string &id) {
+    return std::any_of(std::begin(EXCLUDED_CANDIDATES), std::end(EXCLUDED_CANDIDATES),
+                       [&id](const char *name) { return id == name; });
+}
+
+std::vector<int> calibrationInput(InputShape shape, size_t n, unsigned int seed) {
+    switch (shape) {
+        case InputShape::Random: {
+            std::vector<int> arr(n);
+            std::mt19937 gen(seed);
+            for (auto &value: arr) {
+                value = static_cast<int>(gen());
+            }
+            return arr;
+        }
+        case InputShape::NarrowRange: return generateArray(n, Distribution::Random, seed);
+        case InputShape::Presorted: return generateArray(n, Distribution::NearlySorted, seed);
+        case InputShape::Reversed: return generateArray(n, Distribution::Reversed, seed);
+        case InputShape::FewUnique: return generateArray(n, Distribution::FewUnique, seed);
+    }
+    return {};
+}
+
+// Best nanoseconds per element over a few timed batches; clears `sorted` if any output is out of order
+double nsPerElement(const SortFunction &sort, const std::vector<int> &input, bool &sorted) {
+    size_t copies = std::max<size_t>(1, CALIBRATION_BATCH_ELEMENTS / std::max<size_t>(input.size(), 1));
+    int trials = input.size() >= CALIBRATION_SIZES[std::size(CALIBRATION_SIZES) - 1] ? 2 : 3;
+    const PrecisionTimer &timer = PrecisionTimer::instance();
+
+    double best = std::numeric_limits<double>::infinity();
+    sorted = true;
+    for (int trial = 0; trial < trials; trial++) {
+        std::vector<std::vector<int>> batch(copies, input);
+        uint64_t start = timer.now();
+        for (auto &arr: batch) {
+            sort(arr);
+        }
+        uint64_t end = timer.now();
+        best = std::min(best, timer.elapsedNanoseconds(start, end) / static_cast<double>(copies * input.size()));
+        for (const auto &arr: batch) {
+            sorted = sorted && std::is_sorted(arr.begin(), arr.end());
+        }
+    }
+    return best;
+}
+
+} // namespace
+
+// ============================================
+// Input sampling
+// ============================================
+
+InputSample sampleInput(const std::vector<int> &arr) {
+    InputSample sample;
+    sample.size = arr.size();
+    if (arr.size() < 2) return sample;
+
+    // Evenly spaced neighbour pairs estimate the run structure
+    size_t pairs = std::min({SAMPLE_SIZE, arr.size() - 1, std::max(MIN_SAMPLE_SIZE, arr.size() / SAMPLE_STRIDE)});
+    size_t descents = 0;
+    std::array<int, SAMPLE_SIZE> keys{};
+    for (size_t s = 0; s < pairs; s++) {
+        size_t i = s * (arr.size() - 1) / pairs;
+        descents += arr[i + 1] < arr[i];
+        keys[s] = arr[i];
+    }
+    sample.descent_ratio = static_cast<double>(descents) / static_cast<double>(pairs);
+
+    std::sort(keys.begin(), keys.begin() + pairs);
+    size_t duplicates = 0;
+    for (size_t s = 1; s < pairs; s++) {
+        duplicates += keys[s] == keys[s - 1];
+    }
+    sample.duplicate_ratio = pairs > 1 ? static_cast<double>(duplicates) / static_cast<double>(pairs - 1) : 0.0;
+    sample.key_range = static_cast<uint64_t>(static_cast<int64_t>(keys[pairs - 1]) - keys[0]);
+
+    if (sample.duplicate_ratio >= FEW_UNIQUE_DUPLICATES) {
+        sample.shape = InputShape::FewUnique;
+    } else if (sample.descent_ratio <= PRESORTED_DESCENTS) {
+        sample.shape = InputShape::Presorted;
+    } else if (sample.descent_ratio >= REVERSED_DESCENTS) {
+        sample.shape = InputShape::Reversed;
+    } else if (sample.key_range < NARROW_KEY_RANGE) {
+        sample.shape = InputShape::NarrowRange;
+    } else {
+        sample.shape = InputShape::Random;
+    }
+    return sample;
+}
+
+const char *inputShapeName(InputShape shape) {
+    return SHAPE_NAMES[static_cast<size_t>(shape)];
+}
+
+bool parseInputShape(const std::string &name, InputShape &shape) {
+    for (size_t i = 0; i < std::size(SHAPE_NAMES); i++) {
+        if (name == SHAPE_NAMES[i]) {
+            shape = static_cast<InputShape>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// ============================================
+// Machine profile
+// ============================================
+
+bool SortProfile::load(const std::string &path) {
+    entries_.clear();
+    std::ifstream in(path);
+    if (!in) {
+        if (std::filesystem::exists(path)) {
+            std::cerr << "Error: Could not read sort profile " << path << std::endl;
+        }
+        return false;
+    }
+
+    std::string line;
+    for (size_t line_number = 1; std::getline(in, line); line_number++) {
+        if (line.empty() || line[0] == '#') continue;
+
+        std::istringstream fields(line);
+        ProfileEntry entry{};
+        std::string shape;
+        if (!(fields >> entry.threads >> entry.size >> shape >> entry.algorithm >> entry.ns_per_element) ||
+            !parseInputShape(shape, entry.shape)) {
+            std::cerr << "Error: Malformed line " << line_number << " in sort profile " << path << std::endl;
+            entries_.clear();
+            return false;
+        }
+        entries_.push_back(entry);
+    }
+    return true;
+}
+
+bool SortProfile::save(const std::string &path) const {
+    std::error_code ignored;
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, ignored);
+    }
+    std::ofstream out(path);
+    out << "# sortAuto machine profile: threads size shape algorithm ns_per_element\n";
+    for (const auto &entry: entries_) {
+        out << entry.threads << " " << entry.size << " " << inputShapeName(entry.shape) << " "
+                << entry.algorithm << " " << entry.ns_per_element << "\n";
+    }
+    out.flush();
+    if (!out) {
+        std::cerr << "Error: Could not write sort profile " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool SortProfile::covers(size_t threads) const {
+    return std::any_of(entries_.begin(), entries_.end(),
+                       [threads](const ProfileEntry &entry) { return entry.threads == threads; });
+}
+
+void SortProfile::calibrate(ThreadPool &pool) {
+    size_t threads = pool.size();
+    std::erase_if(entries_, [threads](const ProfileEntry &entry) { return entry.threads == threads; });
+
+    struct Candidate {
+        const AlgorithmInfo *info;
+        SortFunction sort;
+        bool active;
+    };
+    SortEnvironment environment{pool, static_cast<int>(threads), true};
+    std::vector<Candidate> candidates;
+    for (const auto &info: AlgorithmRegistry::instance().algorithms()) {
+        if (info.has(CAP_SEGMENTED) || !info.factory || !(info.key_types & KEY_INT32) || excluded(info.id)) {
+            continue;
+        }
+        candidates.push_back({&info, info.factory(environment), true});
+    }
+
+    unsigned int seed = 42;
+    for (InputShape shape: CALIBRATION_SHAPES) {
+        for (auto &candidate: candidates) {
+            candidate.active = true;
+        }
+
+        for (size_t size: CALIBRATION_SIZES) {
+            std::vector<int> input = calibrationInput(shape, size, seed++);
+            std::vector<double> times(candidates.size(), std::numeric_limits<double>::infinity());
+            size_t best = candidates.size();
+            for (size_t c = 0; c < candidates.size(); c++) {
+                if (!candidates[c].active) continue;
+                bool sorted = true;
+                times[c] = nsPerElement(candidates[c].sort, input, sorted);
+                if (!sorted) {
+                    std::cerr << "  WARNING: " << candidates[c].info->id << " failed calibration; excluded" << std::endl;
+                    times[c] = std::numeric_limits<double>::infinity();
+                    continue;
+                }
+                if (best == candidates.size() || times[c] < times[best]) {
+                    best = c;
+                }
+            }
+            if (best == candidates.size()) continue;
+
+            entries_.push_back({threads, size, shape, candidates[best].info->id, times[best]});
+            for (size_t c = 0; c < candidates.size(); c++) {
+                candidates[c].active = times[c] <= PRUNE_FACTOR * times[best];
+            }
+        }
+    }
+}
+
+const ProfileEntry *SortProfile::choose(size_t threads, size_t n, InputShape shape) const {
+    const ProfileEntry *best = nullptr;
+    double best_distance = 0.0;
+    double log_n = std::log2(static_cast<double>(std::max<size_t>(n, 1)));
+    for (const auto &entry: entries_) {
+        if (entry.threads != threads || entry.shape != shape) continue;
+        double distance = std::abs(std::log2(static_cast<double>(entry.size)) - log_n);
+        if (!best || distance < best_distance) {
+            best = &entry;
+            best_distance = distance;
+        }
+    }
+    return best;
+}
+
+// ============================================
+// sortAuto
+// ============================================
+
+AutoSorter::AutoSorter(ThreadPool &pool, std::string profile_path)
+    : pool_(pool), profile_path_(std::move(profile_path)) {
+}
+
+void AutoSorter::prepare() {
+    if (prepared_) return;
+    prepared_ = true;
+
+    profile_.load(profile_path_);
+    if (!profile_.covers(pool_.size())) {
+        std::cerr << "Calibrating sortAuto for " << pool_.size() << " pool workers (saved to "
+                << profile_path_ << ")..." << std::endl;
+        profile_.calibrate(pool_);
+        profile_.save(profile_path_);
+    }
+}
+
+std::string AutoSorter::choose(const std::vector<int> &arr) {
+    prepare();
+    InputSample sample = sampleInput(arr);
+    const ProfileEntry *entry = profile_.choose(pool_.size(), sample.size, sample.shape);
+    // Profiles can outlive algorithms that were since removed
+    if (entry && AlgorithmRegistry::instance().findById(entry->algorithm)) {
+        return entry->algorithm;
+    }
+    return FALLBACK_ALGORITHM;
+}
+
+void AutoSorter::sort(std::vector<int> &arr) {
+    std::string id = choose(arr);
+    auto engine = engines_.find(id);
+    if (engine == engines_.end()) {
+        const AlgorithmInfo *info = AlgorithmRegistry::instance().findById(id);
+        SortEnvironment environment{pool_, static_cast<int>(pool_.size()), true};
+        engine = engines_.emplace(id, info->factory(environment)).first;
+    }
+    engine->second(arr);
+}
+
+std::string defaultProfilePath() {
+    const char *path = std::getenv("SORT_AUTO_PROFILE");
+    if (path && *path) return path;
+
+    std::filesystem::path cache;
+    if (const char *xdg = std::getenv("XDG_CACHE_HOME"); xdg && *xdg) {
+        cache = xdg;
+    } else if (const char *home = std::getenv("HOME"); home && *home) {
+        cache = std::filesystem::path(home) / ".cache";
+    }
+    if (!cache.empty()) {
+        return (cache / "sort-bench" / "sort_profile.txt").string();
+    }
+    std::error_code error;
+    std::filesystem::path temp = std::filesystem::temp_directory_path(error);
+    return ((error ? std::filesystem::path() : temp) / "sort_profile.txt").string();
+}
+
+void sortAuto(std::vector<int> &arr, ThreadPool &pool) {
+    // One sorter per pool. The registry lock only covers finding the sorter;
+    // concurrent calls on the same pool then take turns on that sorter's lock,
+    // while calls on other pools run (and calibrate) independently.
+    struct Slot {
+        std::mutex mutex;
+        std::unique_ptr<AutoSorter> sorter;
+    };
+    static std::mutex registry_mutex;
+    static std::map<std::pair<const ThreadPool *, size_t>, Slot> sorters;
+
+    Slot *slot;
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        slot = &sorters[{&pool, pool.size()}];
+    }
+    std::lock_guard<std::mutex> lock(slot->mutex);
+    if (!slot->sorter) {
+        slot->sorter = std::make_unique<AutoSorter>(pool, defaultProfilePath());
+    }
+    slot->sorter->sort(arr);
+}
+
+// ============================================
+// Algorithm registration
+// ============================================
+
+namespace {
+
+const AlgorithmRegistrar register_auto({
+    "auto", "Auto-Tuned Sort (sortAuto)",
+    CAP_PARALLEL | CAP_NEEDS_THREADPOOL, KEY_INT32, ExtraMemory::Linear,
+    [](const SortEnvironment &env) {
+        // Calibrate (or load the profile) now rather than inside a timed sort
+        auto sorter = std::make_shared<AutoSorter>(env.pool, defaultProfilePath());
+        sorter->prepare();
+        return SortFunction([sorter](std::vector<int> &arr) { sorter->sort(arr); });
+    },
+    "stl"
+});
+
+} // namespace
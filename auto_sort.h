@@ -0,0 +1,110 @@
+#ifndef AUTO_SORT_H
+#define AUTO_SORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include "algorithm_registry.h"
+
+class ThreadPool;
+
+// Coarse input classes the machine profile distinguishes
+enum class InputShape {
+    Random,         // no order, keys spread over (most of) the 32-bit range
+    NarrowRange,    // no order, keys within a range below 2^24
+    Presorted,      // mostly ascending runs
+    Reversed,       // mostly descending runs
+    FewUnique       // heavy key duplication
+};
+
+// Cheap estimate of an input's properties from a fixed-size sample
+struct InputSample {
+    size_t size = 0;
+    double descent_ratio = 0.0;     // share of sampled neighbours out of order, ~ runs / size
+    double duplicate_ratio = 0.0;   // share of sampled keys equal to another sampled key
+    uint64_t key_range = 0;         // max - min over the sample
+    InputShape shape = InputShape::Random;
+};
+
+// Sample at most a few thousand positions of arr, independent of its size
+InputSample sampleInput(const std::vector<int> &arr);
+
+const char *inputShapeName(InputShape shape);
+
+bool parseInputShape(const std::string &name, InputShape &shape);
+
+// Fastest algorithm measured for one (pool size, input size, input shape) cell
+struct ProfileEntry {
+    size_t threads;
+    size_t size;
+    InputShape shape;
+    std::string algorithm;      // registry id
+    double ns_per_element;
+};
+
+// Per-machine table of the fastest registered algorithm by pool size, input
+// size and input shape, stored as a small text file
+class SortProfile {
+public:
+    // Returns false (with a message on stderr unless the file is missing) when
+    // the file cannot be read or is malformed
+    bool load(const std::string &path);
+
+    bool save(const std::string &path) const;
+
+    // True when the profile has measurements for a pool of this many workers
+    bool covers(size_t threads) const;
+
+    // Time every candidate algorithm on generated inputs of each calibrated
+    // size and shape, and replace the entries for pool.size() workers
+    void calibrate(ThreadPool &pool);
+
+    // Algorithm measured fastest for the nearest calibrated size (on a log
+    // scale) of this shape, or nullptr when the cell was never calibrated
+    const ProfileEntry *choose(size_t threads, size_t n, InputShape shape) const;
+
+    const std::vector<ProfileEntry> &entries() const { return entries_; }
+
+private:
+    std::vector<ProfileEntry> entries_;
+};
+
+// sortAuto's state for one pool: the profile and the engines it has bound so
+// far. Not thread-safe; use one sorter per calling thread.
+class AutoSorter {
+public:
+    AutoSorter(ThreadPool &pool, std::string profile_path);
+
+    // Load the profile, calibrating and saving it first when it has no
+    // entries for this pool's size. Called by the first sort() if not before.
+    void prepare();
+
+    // Registry id of the algorithm sort() would use for arr
+    std::string choose(const std::vector<int> &arr);
+
+    void sort(std::vector<int> &arr);
+
+    const SortProfile &profile() const { return profile_; }
+
+private:
+    ThreadPool &pool_;
+    std::string profile_path_;
+    SortProfile profile_;
+    bool prepared_ = false;
+    std::map<std::string, SortFunction> engines_;    // bound lazily, each with its own SortContext
+};
+
+// Where sortAuto keeps the machine profile: $SORT_AUTO_PROFILE, else
+// sort-bench/sort_profile.txt under $XDG_CACHE_HOME (or ~/.cache), else
+// sort_profile.txt in the system temp directory
+std::string defaultProfilePath();
+
+// Sort with the engine the machine profile found fastest for inputs of this
+// size and shape. The first call on a pool loads the profile from
+// defaultProfilePath(), running the calibration and saving its result if the
+// profile has nothing for this pool size yet.
+void sortAuto(std::vector<int> &arr, ThreadPool &pool);
+
+#endif // AUTO_SORT_H
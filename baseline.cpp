@@ -0,0 +1,380 @@
+#include "baseline.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+// ============================================
+// Minimal JSON reader/writer for baseline files
+// ============================================
+
+namespace {
+
+struct JsonValue {
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> array;
+    std::vector<std::pair<std::string, JsonValue>> object;
+
+    const JsonValue *get(const std::string &key) const {
+        for (const auto &member: object) {
+            if (member.first == key) {
+                return &member.second;
+            }
+        }
+        return nullptr;
+    }
+};
+
+class JsonParser {
+public:
+    explicit JsonParser(const std::string &text) : text_(text) {
+    }
+
+    bool parse(JsonValue &out) {
+        if (!parseValue(out)) return false;
+        skipWhitespace();
+        return pos_ == text_.size();
+    }
+
+private:
+    const std::string &text_;
+    size_t pos_ = 0;
+
+    void skipWhitespace() {
+        while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) {
+            pos_++;
+        }
+    }
+
+    bool consume(char c) {
+        skipWhitespace();
+        if (pos_ < text_.size() && text_[pos_] == c) {
+            pos_++;
+            return true;
+        }
+        return false;
+    }
+
+    bool consumeLiteral(const char *literal) {
+        size_t len = std::char_traits<char>::length(literal);
+        if (text_.compare(pos_, len, literal) != 0) return false;
+        pos_ += len;
+        return true;
+    }
+
+    bool parseString(std::string &out) {
+        if (!consume('"')) return false;
+        out.clear();
+        while (pos_ < text_.size()) {
+            char c = text_[pos_++];
+            if (c == '"') return true;
+            if (c == '\\') {
+                if (pos_ >= text_.size()) return false;
+                char esc = text_[pos_++];
+                switch (esc) {
+                    case 'n': out += '\n'; break;
+                    case 't': out += '\t'; break;
+                    case 'r': out += '\r'; break;
+                    case 'b': out += '\b'; break;
+                    case 'f': out += '\f'; break;
+                    case 'u':
+                        // Baselines only ever contain ASCII; keep the code point's low byte
+                        if (pos_ + 4 > text_.size()) return false;
+                        out += static_cast<char>(std::strtol(text_.substr(pos_, 4).c_str(), nullptr, 16));
+                        pos_ += 4;
+                        break;
+                    default: out += esc; break;
+                }
+            } else {
+                out += c;
+            }
+        }
+        return false;
+    }
+
+    bool parseValue(JsonValue &out) {
+        skipWhitespace();
+        if (pos_ >= text_.size()) return false;
+
+        char c = text_[pos_];
+        if (c == '{') {
+            pos_++;
+            out.type = JsonValue::Type::Object;
+            if (consume('}')) return true;
+            do {
+                std::string key;
+                JsonValue value;
+                if (!parseString(key) || !consume(':') || !parseValue(value)) return false;
+                out.object.emplace_back(std::move(key), std::move(value));
+            } while (consume(','));
+            return consume('}');
+        }
+        if (c == '[') {
+            pos_++;
+            out.type = JsonValue::Type::Array;
+            if (consume(']')) return true;
+            do {
+                JsonValue value;
+                if (!parseValue(value)) return false;
+                out.array.push_back(std::move(value));
+            } while (consume(','));
+            return consume(']');
+        }
+        if (c == '"') {
+            out.type = JsonValue::Type::String;
+            return parseString(out.string);
+        }
+        if (consumeLiteral("true")) {
+            out.type = JsonValue::Type::Bool;
+            out.boolean = true;
+            return true;
+        }
+        if (consumeLiteral("false")) {
+            out.type = JsonValue::Type::Bool;
+            return true;
+        }
+        if (consumeLiteral("null")) {
+            return true;
+        }
+
+        const char *begin = text_.c_str() + pos_;
+        char *end = nullptr;
+        out.type = JsonValue::Type::Number;
+        out.number = std::strtod(begin, &end);
+        if (end == begin) return false;
+        pos_ += end - begin;
+        return true;
+    }
+};
+
+} // namespace
+
+std::string jsonEscape(const std::string &s) {
+    std::string out;
+    for (char c: s) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            case '\r': out += "\\r"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char code[7];
+                    std::snprintf(code, sizeof(code), "\\u%04x", static_cast<unsigned>(c));
+                    out += code;
+                } else {
+                    out += c;
+                }
+                break;
+        }
+    }
+    return out;
+}
+
+// ============================================
+// Baseline storage
+// ============================================
+
+const BaselineEntry *Baseline::find(const std::string &algorithm_name, size_t array_size,
+                                    const std::string &distribution) const {
+    for (const auto &entry: entries) {
+        if (entry.algorithm_name == algorithm_name && entry.array_size == array_size &&
+            entry.distribution == distribution) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+std::string currentMachineTag() {
+    std::string host = "unknown-host";
+#ifdef _WIN32
+    if (const char *name = std::getenv("COMPUTERNAME")) {
+        host = name;
+    }
+#else
+    char name[256] = {};
+    if (gethostname(name, sizeof(name) - 1) == 0 && name[0] != '\0') {
+        host = name;
+    }
+#endif
+
+    std::ostringstream tag;
+    tag << host << "/" << std::thread::hardware_concurrency() << "-threads/";
+#if defined(__clang__)
+    tag << "clang-" << __clang_major__ << "." << __clang_minor__;
+#elif defined(__GNUC__)
+    tag << "gcc-" << __GNUC__ << "." << __GNUC_MINOR__;
+#elif defined(_MSC_VER)
+    tag << "msvc-" << _MSC_VER;
+#else
+    tag << "unknown-compiler";
+#endif
+    return tag.str();
+}
+
+bool saveBaseline(const std::string &path, const Baseline &baseline) {
+    std::ofstream file(path);
+
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open baseline file " << path << std::endl;
+        return false;
+    }
+
+    file << "{\n";
+    file << "  \"machine\": \"" << jsonEscape(baseline.machine_tag) << "\",\n";
+    file << "  \"unit\": \"ns\",\n";
+    file << "  \"results\": [\n";
+    for (size_t i = 0; i < baseline.entries.size(); i++) {
+        const BaselineEntry &entry = baseline.entries[i];
+        file << "    {\"algorithm\": \"" << jsonEscape(entry.algorithm_name) << "\", "
+                << "\"array_size\": " << entry.array_size << ", "
+                << "\"distribution\": \"" << jsonEscape(entry.distribution) << "\", \"samples\": [";
+        for (size_t j = 0; j < entry.samples.size(); j++) {
+            file << (j ? ", " : "") << std::setprecision(17) << entry.samples[j];
+        }
+        file << "]}" << (i + 1 < baseline.entries.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n";
+    file << "}\n";
+
+    return static_cast<bool>(file);
+}
+
+bool loadBaseline(const std::string &path, Baseline &baseline) {
+    std::ifstream file(path);
+
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open baseline file " << path << std::endl;
+        return false;
+    }
+
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string text = buffer.str();
+
+    JsonValue root;
+    JsonParser parser(text);
+    if (!parser.parse(root) || root.type != JsonValue::Type::Object) {
+        std::cerr << "Error: Malformed baseline file " << path << std::endl;
+        return false;
+    }
+
+    baseline = Baseline();
+    if (const JsonValue *machine = root.get("machine")) {
+        baseline.machine_tag = machine->string;
+    }
+
+    // Baselines written before nanosecond timing stored microseconds and no unit
+    const JsonValue *unit = root.get("unit");
+    double to_nanoseconds = (unit && unit->string == "ns") ? 1.0 : 1000.0;
+
+    const JsonValue *results = root.get("results");
+    if (!results || results->type != JsonValue::Type::Array) {
+        std::cerr << "Error: Baseline file " << path << " has no results array" << std::endl;
+        return false;
+    }
+
+    for (const auto &item: results->array) {
+        const JsonValue *algorithm = item.get("algorithm");
+        const JsonValue *array_size = item.get("array_size");
+        const JsonValue *distribution = item.get("distribution");
+        const JsonValue *samples = item.get("samples");
+        if (!algorithm || !array_size || !samples || samples->type != JsonValue::Type::Array) {
+            std::cerr << "Error: Malformed result entry in baseline file " << path << std::endl;
+            return false;
+        }
+
+        BaselineEntry entry;
+        entry.algorithm_name = algorithm->string;
+        entry.array_size = static_cast<size_t>(array_size->number);
+        entry.distribution = distribution ? distribution->string : "random";
+        for (const auto &sample: samples->array) {
+            entry.samples.push_back(sample.number * to_nanoseconds);
+        }
+        baseline.entries.push_back(std::move(entry));
+    }
+
+    return true;
+}
+
+// ============================================
+// Statistics
+// ============================================
+
+double median(std::vector<double> values) {
+    if (values.empty()) return 0.0;
+
+    size_t mid = values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + mid, values.end());
+    double upper = values[mid];
+    if (values.size() % 2 == 1) return upper;
+
+    double lower = *std::max_element(values.begin(), values.begin() + mid);
+    return (lower + upper) / 2.0;
+}
+
+MannWhitneyResult mannWhitneyU(const std::vector<double> &a, const std::vector<double> &b) {
+    MannWhitneyResult result{0.0, 0.0, 1.0};
+
+    const double n1 = static_cast<double>(a.size());
+    const double n2 = static_cast<double>(b.size());
+    if (a.empty() || b.empty()) return result;
+
+    // Pool both samples, remembering which one each value came from
+    std::vector<std::pair<double, bool>> pooled;
+    pooled.reserve(a.size() + b.size());
+    for (double v: a) pooled.emplace_back(v, true);
+    for (double v: b) pooled.emplace_back(v, false);
+    std::sort(pooled.begin(), pooled.end(),
+              [](const auto &x, const auto &y) { return x.first < y.first; });
+
+    // Assign average ranks to ties and accumulate the tie correction term
+    double rank_sum_a = 0.0;
+    double tie_term = 0.0;
+    for (size_t i = 0; i < pooled.size();) {
+        size_t j = i;
+        while (j < pooled.size() && pooled[j].first == pooled[i].first) {
+            j++;
+        }
+        double avg_rank = (static_cast<double>(i + 1) + static_cast<double>(j)) / 2.0;
+        for (size_t k = i; k < j; k++) {
+            if (pooled[k].second) rank_sum_a += avg_rank;
+        }
+        double t = static_cast<double>(j - i);
+        tie_term += t * t * t - t;
+        i = j;
+    }
+
+    const double n = n1 + n2;
+    result.u = rank_sum_a - n1 * (n1 + 1.0) / 2.0;
+
+    double mean_u = n1 * n2 / 2.0;
+    double var_u = n1 * n2 / 12.0 * ((n + 1.0) - tie_term / (n * (n - 1.0)));
+    if (var_u <= 0.0) return result; // All values identical
+
+    // Continuity-corrected normal approximation, two-sided
+    double diff = result.u - mean_u;
+    double corrected = std::max(std::fabs(diff) - 0.5, 0.0);
+    result.z = std::copysign(corrected / std::sqrt(var_u), diff);
+    result.p_value = std::erfc(std::fabs(result.z) / std::sqrt(2.0));
+
+    return result;
+}
@@ -0,0 +1,50 @@
+#ifndef BASELINE_H
+#define BASELINE_H
+
+#include <string>
+#include <vector>
+
+// Per-iteration samples (nanoseconds) of one algorithm at one array size and distribution
+struct BaselineEntry {
+    std::string algorithm_name;
+    size_t array_size;
+    std::string distribution;
+    std::vector<double> samples;
+};
+
+// A stored benchmark run, tagged with the machine that produced it
+struct Baseline {
+    std::string machine_tag;
+    std::vector<BaselineEntry> entries;
+
+    const BaselineEntry *find(const std::string &algorithm_name, size_t array_size,
+                              const std::string &distribution) const;
+};
+
+// Result of a two-sided Mann-Whitney U test
+struct MannWhitneyResult {
+    double u;
+    double z;
+    double p_value;
+};
+
+// Identify the host (hostname, hardware threads, compiler) so baselines are not
+// silently compared across machines
+std::string currentMachineTag();
+
+// Write/read a baseline as JSON; both return false on I/O or parse errors
+bool saveBaseline(const std::string &path, const Baseline &baseline);
+
+bool loadBaseline(const std::string &path, Baseline &baseline);
+
+// s as the body of a JSON string literal: quotes, backslashes and control
+// characters escaped
+std::string jsonEscape(const std::string &s);
+
+// Rank-sum test of sample a against sample b (normal approximation, tie-corrected)
+MannWhitneyResult mannWhitneyU(const std::vector<double> &a, const std::vector<double> &b);
+
+// Median of a sample (0.0 for an empty sample)
+double median(std::vector<double> values);
+
+#endif // BASELINE_H
@@ -1,119 +1,793 @@
 #include "benchmark.h"
 #include "sorting_algorithms.h"
-#include <chrono>
+#include "baseline.h"
+#include "external_sort.h"
+#include "mapped_sort.h"
+#include "distributed_sort.h"
+#include "algorithm_registry.h"
+#include "isolation.h"
+#include "ThreadPool.h"
+#include "timer.h"
+#include "verification.h"
+#include <cstdio>
+#include <cstring>
 #include <iostream>
+#include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <random>
 #include <cmath>
 #include <algorithm>
+#include <limits>
 
 BenchmarkRunner::BenchmarkRunner(const BenchmarkConfig &config)
     : config_(config) {
 }
 
-std::vector<int> BenchmarkRunner::generateRandomArray() const {
-    std::vector<int> arr(config_.array_size);
-    std::mt19937 gen(config_.random_seed);
-    std::uniform_int_distribution<> dis(1, 1000000);
+void BenchmarkRunner::setArraySize(size_t array_size) {
+    config_.array_size = array_size;
+}
+
+void BenchmarkRunner::setDistribution(Distribution distribution) {
+    config_.distribution = distribution;
+}
+
+BenchmarkResult BenchmarkRunner::measureIteration(
+    const std::string &algorithm_name,
+    const std::function<void(std::vector<int> &)> &sort_function,
+    int iteration
+) const {
+    // Generate a fresh input array for each iteration; small inputs get one
+    // copy per sort in the batch so every sort starts from unsorted data
+    int batch = batchSize();
+    std::vector<int> input = generateArray(config_.array_size, config_.distribution, config_.random_seed);
+    std::vector<std::vector<int>> arrays(batch, input);
+    MultisetFingerprint input_fingerprint = fingerprint(input.data(), input.size());
 
-    for (size_t i = 0; i < config_.array_size; i++) {
-        arr[i] = dis(gen);
+    // Measure execution time and memory use
+    const PrecisionTimer &timer = PrecisionTimer::instance();
+    MemoryRegion memory_region;
+    uint64_t start = timer.now();
+    for (auto &arr: arrays) {
+        sort_function(arr);
     }
+    uint64_t end = timer.now();
+    MemoryUsage memory = memory_region.finish();
+    memory.allocation_count /= batch;
+    memory.bytes_allocated /= batch;
+    memory.scratch_allocation_count /= batch;
+    memory.scratch_bytes_allocated /= batch;
 
-    return arr;
+    BenchmarkResult result;
+    result.algorithm_name = algorithm_name;
+    result.array_size = config_.array_size;
+    result.distribution = config_.distribution;
+    result.iteration = iteration;
+    result.time_nanoseconds = timer.elapsedNanoseconds(start, end) / batch;
+    result.batch_size = batch;
+    result.is_sorted = true;
+    result.is_permutation = true;
+    result.segments = 0;
+    result.memory = memory;
+
+    // Verify correctness outside the timed region
+    for (const auto &arr: arrays) {
+        VerificationResult verification = verifySortedPermutation(input_fingerprint, arr);
+        result.is_sorted = result.is_sorted && verification.is_sorted;
+        result.is_permutation = result.is_permutation && verification.is_permutation;
+    }
+    return result;
+}
+
+int BenchmarkRunner::batchSize() const {
+    if (config_.array_size == 0 || config_.array_size >= config_.batch_threshold) {
+        return 1;
+    }
+    size_t batch = config_.batch_elements / config_.array_size;
+    return static_cast<int>(std::clamp<size_t>(batch, 1, 100000));
+}
+
+void BenchmarkRunner::reportIteration(const BenchmarkResult &result) const {
+    if (config_.verbose) {
+        std::cout << "  Iteration " << result.iteration << "/" << config_.iterations
+                << ": " << formatDuration(result.time_nanoseconds);
+        if (result.batch_size > 1) {
+            std::cout << " (avg of " << result.batch_size << ")";
+        }
+        std::cout << (result.is_sorted && result.is_permutation ? " [PASS]" : " [FAIL]") << std::endl;
+    }
+
+    if (!result.is_sorted) {
+        std::cerr << "  WARNING: Array is not properly sorted!" << std::endl;
+    }
+    if (!result.is_permutation) {
+        std::cerr << "  WARNING: Output is not a permutation of the input (elements lost or duplicated)!"
+                << std::endl;
+    }
 }
 
 void BenchmarkRunner::runAlgorithm(
     const std::string &algorithm_name,
     std::function<void(std::vector<int> &)> sort_function
 ) {
-    std::cout << "Running " << algorithm_name << "..." << std::endl;
+    std::cout << "Running " << algorithm_name << " (" << config_.array_size << " elements, "
+            << distributionName(config_.distribution) << ")..." << std::endl;
 
     for (int i = 0; i < config_.iterations; i++) {
-        // Generate a fresh random array for each iteration
-        std::vector<int> arr = generateRandomArray();
+        BenchmarkResult result = measureIteration(algorithm_name, sort_function, i + 1);
+        results_.push_back(result);
+        reportIteration(result);
+    }
 
-        // Measure execution time
-        auto start = std::chrono::high_resolution_clock::now();
-        sort_function(arr);
-        auto end = std::chrono::high_resolution_clock::now();
+    std::cout << std::endl;
+}
 
-        // Calculate elapsed time in microseconds
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-        double time_us = duration.count();
+void BenchmarkRunner::runSegmented(
+    const std::string &algorithm_name,
+    const std::function<void(std::vector<int> &, const std::vector<size_t> &)> &sort_function
+) {
+    std::cout << "Running " << algorithm_name << " (" << config_.array_size << " elements in segments of "
+            << config_.segment_min << "-" << config_.segment_max << ", "
+            << distributionName(config_.distribution) << ")..." << std::endl;
 
-        // Verify correctness
-        bool is_sorted = isSorted(arr);
+    std::vector<int> input = generateArray(config_.array_size, config_.distribution, config_.random_seed);
+    std::vector<size_t> offsets = generateSegmentOffsets(config_.array_size, config_.segment_min,
+                                                         config_.segment_max, config_.random_seed);
+    size_t segment_count = offsets.size() - 1;
+
+    // Per-segment fingerprints also catch elements that moved between segments
+    std::vector<MultisetFingerprint> input_fingerprints(segment_count);
+    for (size_t s = 0; s < segment_count; s++) {
+        input_fingerprints[s] = fingerprint(input.data() + offsets[s], offsets[s + 1] - offsets[s]);
+    }
+
+    const PrecisionTimer &timer = PrecisionTimer::instance();
+    for (int i = 0; i < config_.iterations; i++) {
+        std::vector<int> values = input;
+
+        MemoryRegion memory_region;
+        uint64_t start = timer.now();
+        sort_function(values, offsets);
+        uint64_t end = timer.now();
+        MemoryUsage memory = memory_region.finish();
 
-        // Store result
         BenchmarkResult result;
         result.algorithm_name = algorithm_name;
         result.array_size = config_.array_size;
+        result.distribution = config_.distribution;
         result.iteration = i + 1;
-        result.time_microseconds = time_us;
-        result.is_sorted = is_sorted;
+        result.time_nanoseconds = timer.elapsedNanoseconds(start, end);
+        result.batch_size = 1;
+        result.is_sorted = true;
+        result.is_permutation = true;
+        result.segments = segment_count;
+        result.memory = memory;
+
+        for (size_t s = 0; s < segment_count; s++) {
+            const int *segment = values.data() + offsets[s];
+            size_t length = offsets[s + 1] - offsets[s];
+            result.is_sorted = result.is_sorted && isSortedParallel(segment, length);
+            result.is_permutation = result.is_permutation && fingerprint(segment, length) == input_fingerprints[s];
+        }
 
         results_.push_back(result);
+        reportIteration(result);
+    }
 
-        std::cout << "  Iteration " << (i + 1) << "/" << config_.iterations
-                << ": " << std::fixed << std::setprecision(2)
-                << time_us / 1000.0 << " ms"
-                << (is_sorted ? " [PASS]" : " [FAIL]")
-                << std::endl;
+    std::cout << std::endl;
+}
+
+void BenchmarkRunner::runSelection(ThreadPool &pool) {
+    std::vector<int> input = generateArray(config_.array_size, config_.distribution, config_.random_seed);
+    size_t n = input.size();
+    size_t k = std::min(config_.select_k, n);
+    if (k == n && n > 0) {
+        k = n - 1;    // nth element needs a valid rank
+    }
+
+    // What a correct full sort would produce, to check every method against
+    std::vector<int> reference = input;
+    std::sort(reference.begin(), reference.end());
+    MultisetFingerprint input_fingerprint = fingerprint(input.data(), n);
+    MultisetFingerprint prefix_fingerprint = fingerprint(reference.data(), k);
+
+    // Methods either leave the k smallest elements sorted at the front (or
+    // return just those), or place the element of rank k
+    enum class Check { Prefix, Nth };
+    struct Method {
+        std::string name;
+        Check check;
+        std::function<void(std::vector<int> &)> run;
+    };
+    const Method methods[] = {
+        {"Full Sort (ThreadPool merge)", Check::Prefix, [&](std::vector<int> &v) { mergeSortThreadPool(v, pool); }},
+        {"std::partial_sort", Check::Prefix, [k](std::vector<int> &v) {
+            std::partial_sort(v.begin(), v.begin() + k, v.end());
+        }},
+        {"partialSortParallel", Check::Prefix, [&](std::vector<int> &v) { partialSortParallel(v, k, pool); }},
+        {"topK (bounded heaps)", Check::Prefix, [&](std::vector<int> &v) { v = topK(v, k, pool); }},
+        {"std::nth_element", Check::Nth, [k](std::vector<int> &v) {
+            std::nth_element(v.begin(), v.begin() + k, v.end());
+        }},
+        {"nthElementParallel", Check::Nth, [&](std::vector<int> &v) { nthElementParallel(v, k, pool); }},
+    };
+
+    const PrecisionTimer &timer = PrecisionTimer::instance();
+    for (const auto &method: methods) {
+        std::cout << "Running " << method.name << " (k = " << k << " of " << n << " elements, "
+                << distributionName(config_.distribution) << ")..." << std::endl;
+
+        for (int i = 0; i < config_.iterations; i++) {
+            std::vector<int> values = input;
+
+            MemoryRegion memory_region;
+            uint64_t start = timer.now();
+            method.run(values);
+            uint64_t end = timer.now();
+            MemoryUsage memory = memory_region.finish();
+
+            BenchmarkResult result;
+            result.algorithm_name = method.name;
+            result.array_size = n;
+            result.distribution = config_.distribution;
+            result.iteration = i + 1;
+            result.time_nanoseconds = timer.elapsedNanoseconds(start, end);
+            result.batch_size = 1;
+            result.segments = 0;
+            result.memory = memory;
+
+            if (n == 0) {
+                result.is_sorted = values.empty();
+            } else if (method.check == Check::Prefix) {
+                result.is_sorted = values.size() >= k && std::equal(reference.begin(), reference.begin() + k,
+                                                                    values.begin());
+            } else {
+                int nth = values[k];
+                result.is_sorted = nth == reference[k] &&
+                                   std::all_of(values.begin(), values.begin() + k, [nth](int v) { return v <= nth; }) &&
+                                   std::all_of(values.begin() + k, values.end(), [nth](int v) { return v >= nth; });
+            }
+            result.is_permutation = values.size() == n
+                                        ? fingerprint(values.data(), n) == input_fingerprint
+                                        : fingerprint(values.data(), values.size()) == prefix_fingerprint;
+
+            results_.push_back(result);
+            reportIteration(result);
+        }
+        std::cout << std::endl;
+    }
+}
+
+namespace {
+
+// Keys per block when generating or streaming external sort files
+constexpr size_t FILE_BLOCK_ELEMENTS = size_t(1) << 20;
+
+// Write `count` keys of the configured pattern to `path`, one block at a time so
+// the file can exceed RAM. Each block gets its own seed, so ordered patterns
+// (sorted, organ-pipe, ...) repeat per block rather than spanning the file.
+// 64-bit keys are the generated 32-bit values sign-extended.
+template<class Key>
+bool writeInputFile(const std::string &path, size_t count, Distribution distribution, unsigned int seed) {
+    std::FILE *file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Error: Could not create " << path << std::endl;
+        return false;
+    }
+
+    bool ok = true;
+    for (size_t written = 0, block = 0; ok && written < count; block++) {
+        size_t block_size = std::min(FILE_BLOCK_ELEMENTS, count - written);
+        std::vector<int> generated = generateArray(block_size, distribution, seed + static_cast<unsigned int>(block));
+        std::vector<Key> keys(generated.begin(), generated.end());
+        ok = std::fwrite(keys.data(), sizeof(Key), block_size, file) == block_size;
+        written += block_size;
+    }
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        std::cerr << "Error: Failed writing " << path << std::endl;
+    }
+    return ok;
+}
 
-        if (!is_sorted) {
-            std::cerr << "  WARNING: Array is not properly sorted!" << std::endl;
+// Stream a key file, fingerprinting it and checking that it is non-decreasing
+// (including across block boundaries)
+template<class Key>
+bool scanFile(const std::string &path, MultisetFingerprint &file_fingerprint, bool &is_sorted) {
+    std::FILE *file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        std::cerr << "Error: Could not open " << path << std::endl;
+        return false;
+    }
+
+    file_fingerprint = MultisetFingerprint();
+    is_sorted = true;
+    std::vector<Key> block(FILE_BLOCK_ELEMENTS);
+    bool has_previous = false;
+    Key previous = 0;
+    size_t count;
+    while ((count = std::fread(block.data(), sizeof(Key), block.size(), file)) > 0) {
+        file_fingerprint += fingerprint(block.data(), count);
+        if (has_previous && block[0] < previous) {
+            is_sorted = false;
+        }
+        is_sorted = is_sorted && isSortedParallel(block.data(), count);
+        previous = block[count - 1];
+        has_previous = true;
+    }
+    std::fclose(file);
+    return true;
+}
+
+} // namespace
+
+void BenchmarkRunner::runExternalSort(ThreadPool &pool) {
+    const std::string algorithm_name = "External Merge Sort";
+
+    std::string input_path;
+    bool generated_input = config_.external_input == nullptr;
+    if (generated_input) {
+        std::error_code error;
+        std::filesystem::path directory = config_.temp_dir ? std::filesystem::path(config_.temp_dir)
+                                                           : std::filesystem::temp_directory_path(error);
+        input_path = (directory / "external_sort_input.bin").string();
+        if (error || !writeInputFile<int>(input_path, config_.array_size, config_.distribution, config_.random_seed)) {
+            return;
+        }
+    } else {
+        input_path = config_.external_input;
+    }
+    std::string output_path = config_.external_output ? config_.external_output : input_path + ".sorted";
+
+    MultisetFingerprint input_fingerprint;
+    bool input_sorted = false;
+    if (!scanFile<int>(input_path, input_fingerprint, input_sorted)) {
+        return;
+    }
+    size_t element_count = static_cast<size_t>(input_fingerprint.count);
+
+    std::cout << "Running " << algorithm_name << " (" << element_count << " elements from " << input_path
+            << ", memory cap " << (config_.memory_cap >> 20) << " MB)..." << std::endl;
+
+    ExternalSortOptions options;
+    options.memory_limit_bytes = config_.memory_cap;
+    if (config_.temp_dir) {
+        options.temp_directory = config_.temp_dir;
+    }
+
+    for (int i = 0; i < config_.iterations; i++) {
+        ExternalSortStats stats;
+        MemoryRegion memory_region;
+        bool ok = externalSort(input_path, output_path, options, pool, stats);
+        MemoryUsage memory = memory_region.finish();
+
+        BenchmarkResult result;
+        result.algorithm_name = algorithm_name;
+        result.array_size = element_count;
+        result.distribution = config_.distribution;
+        result.iteration = i + 1;
+        result.time_nanoseconds = stats.totalSeconds() * 1e9;
+        result.batch_size = 1;
+        result.is_sorted = false;
+        result.is_permutation = false;
+        result.segments = 0;
+        result.memory = memory;
+
+        MultisetFingerprint output_fingerprint;
+        if (ok && scanFile<int>(output_path, output_fingerprint, result.is_sorted)) {
+            result.is_permutation = output_fingerprint == input_fingerprint;
+        }
+
+        results_.push_back(result);
+        reportIteration(result);
+        if (config_.verbose && ok) {
+            std::cout << "    " << stats.runs << " runs, " << stats.merge_passes
+                    << " intermediate merge passes, run phase " << formatDuration(stats.run_phase_seconds * 1e9)
+                    << ", merge phase " << formatDuration(stats.merge_phase_seconds * 1e9) << ", "
+                    << std::fixed << std::setprecision(1) << stats.throughputMBps() << " MB/s" << std::endl;
+        }
+    }
+
+    if (generated_input) {
+        std::error_code ignored;
+        std::filesystem::remove(input_path, ignored);
+        if (!config_.external_output) {
+            std::filesystem::remove(output_path, ignored);
         }
     }
 
     std::cout << std::endl;
 }
 
-AlgorithmStats BenchmarkRunner::calculateStats(const std::string &algorithm_name) const {
+void BenchmarkRunner::runMappedSort(ThreadPool &pool) {
+    KeyWidth width = config_.key_bits == 64 ? KeyWidth::Int64 : KeyWidth::Int32;
+    auto write_keys = width == KeyWidth::Int64 ? writeInputFile<int64_t> : writeInputFile<int>;
+    auto scan_keys = width == KeyWidth::Int64 ? scanFile<int64_t> : scanFile<int>;
+
+    std::error_code error;
+    std::filesystem::path directory = config_.temp_dir ? std::filesystem::path(config_.temp_dir)
+                                                       : std::filesystem::temp_directory_path(error);
+    if (error) {
+        std::cerr << "Error: No temp directory available: " << error.message() << std::endl;
+        return;
+    }
+
+    // Both methods sort a fresh copy of the source in place, so the source survives
+    std::string source_path;
+    bool generated_input = config_.external_input == nullptr;
+    if (generated_input) {
+        source_path = (directory / "mapped_sort_input.bin").string();
+        if (!write_keys(source_path, config_.array_size, config_.distribution, config_.random_seed)) {
+            return;
+        }
+    } else {
+        source_path = config_.external_input;
+    }
+    std::string work_path = (directory / "mapped_sort_work.bin").string();
+
+    MultisetFingerprint input_fingerprint;
+    bool input_sorted = false;
+    if (!scan_keys(source_path, input_fingerprint, input_sorted)) {
+        return;
+    }
+    size_t element_count = static_cast<size_t>(input_fingerprint.count);
+    std::string suffix = width == KeyWidth::Int64 ? " (int64)" : " (int32)";
+
+    struct Method {
+        std::string name;
+        std::function<bool(FileSortStats &)> sort;
+    };
+    const Method methods[] = {
+        {"Mapped In-Place Sort" + suffix, [&](FileSortStats &stats) {
+            return sortFileMapped(work_path, width, MappedSortOptions(), pool, stats);
+        }},
+        {"Read-Sort-Write" + suffix, [&](FileSortStats &stats) {
+            return sortFileBuffered(work_path, width, pool, stats);
+        }},
+    };
+
+    for (const auto &method: methods) {
+        std::cout << "Running " << method.name << " (" << element_count << " elements from " << source_path
+                << ")..." << std::endl;
+
+        for (int i = 0; i < config_.iterations; i++) {
+            std::filesystem::copy_file(source_path, work_path, std::filesystem::copy_options::overwrite_existing,
+                                       error);
+            if (error) {
+                std::cerr << "Error: Could not copy " << source_path << ": " << error.message() << std::endl;
+                return;
+            }
+
+            FileSortStats stats;
+            MemoryRegion memory_region;
+            bool ok = method.sort(stats);
+            MemoryUsage memory = memory_region.finish();
+
+            BenchmarkResult result;
+            result.algorithm_name = method.name;
+            result.array_size = element_count;
+            result.distribution = config_.distribution;
+            result.iteration = i + 1;
+            result.time_nanoseconds = stats.totalSeconds() * 1e9;
+            result.batch_size = 1;
+            result.is_sorted = false;
+            result.is_permutation = false;
+            result.segments = 0;
+            result.memory = memory;
+
+            MultisetFingerprint output_fingerprint;
+            if (ok && scan_keys(work_path, output_fingerprint, result.is_sorted)) {
+                result.is_permutation = output_fingerprint == input_fingerprint;
+            }
+
+            results_.push_back(result);
+            reportIteration(result);
+            if (config_.verbose && ok) {
+                std::cout << "    load " << formatDuration(stats.load_seconds * 1e9)
+                        << ", sort " << formatDuration(stats.sort_seconds * 1e9)
+                        << ", store " << formatDuration(stats.store_seconds * 1e9) << ", "
+                        << std::fixed << std::setprecision(1) << stats.throughputMBps() << " MB/s"
+                        << (stats.huge_pages ? ", huge pages" : "") << std::endl;
+            }
+        }
+        std::cout << std::endl;
+    }
+
+    std::filesystem::remove(work_path, error);
+    if (generated_input) {
+        std::filesystem::remove(source_path, error);
+    }
+}
+
+void BenchmarkRunner::runDistributedSort() {
+    DistributedSortOptions options;
+    options.workers = config_.distributed_workers;
+    options.threads_per_worker = std::max<size_t>(1, static_cast<size_t>(config_.threadpool_size) / options.workers);
+    options.seed = config_.random_seed;
+    const std::string algorithm_name = "Distributed Sample Sort (" + std::to_string(options.workers) + " workers x " +
+                                       std::to_string(options.threads_per_worker) + " threads)";
+
+    std::vector<int> input = generateArray(config_.array_size, config_.distribution, config_.random_seed);
+    MultisetFingerprint input_fingerprint = fingerprint(input.data(), input.size());
+
+    std::cout << "Running " << algorithm_name << " (" << input.size() << " elements, "
+            << distributionName(config_.distribution) << ")..." << std::endl;
+
+    for (int i = 0; i < config_.iterations; i++) {
+        std::vector<int> values = input;
+
+        DistributedSortStats stats;
+        MemoryRegion memory_region;
+        bool ok = distributedSort(values, options, stats);
+        MemoryUsage memory = memory_region.finish();
+
+        BenchmarkResult result;
+        result.algorithm_name = algorithm_name;
+        result.array_size = input.size();
+        result.distribution = config_.distribution;
+        result.iteration = i + 1;
+        result.time_nanoseconds = stats.totalSeconds() * 1e9;
+        result.batch_size = 1;
+        result.is_sorted = false;
+        result.is_permutation = false;
+        result.segments = 0;
+        result.memory = memory;
+        if (ok) {
+            VerificationResult verification = verifySortedPermutation(input_fingerprint, values);
+            result.is_sorted = verification.is_sorted;
+            result.is_permutation = verification.is_permutation;
+        }
+
+        results_.push_back(result);
+        reportIteration(result);
+        if (config_.verbose && ok) {
+            std::cout << "    setup " << formatDuration(stats.setup_seconds * 1e9)
+                    << ", sampling " << formatDuration(stats.sampling_seconds * 1e9)
+                    << ", exchange " << formatDuration(stats.exchange_seconds * 1e9)
+                    << ", local sort " << formatDuration(stats.local_sort_seconds * 1e9)
+                    << ", collect " << formatDuration(stats.collect_seconds * 1e9) << ", imbalance "
+                    << std::fixed << std::setprecision(2) << stats.imbalance() << std::endl;
+        }
+    }
+    std::cout << std::endl;
+}
+
+void BenchmarkRunner::runStringSort(ThreadPool &pool) {
+    StringArena arena = generateStrings(config_.array_size, config_.distribution, config_.random_seed);
+    const std::vector<std::string_view> input = arena.views();
+
+    // Multiset of the string contents, through a 64-bit hash of each
+    auto string_fingerprint = [](const std::vector<std::string_view> &strings) {
+        std::vector<int64_t> hashes(strings.size());
+        for (size_t i = 0; i < strings.size(); i++) {
+            hashes[i] = static_cast<int64_t>(std::hash<std::string_view>{}(strings[i]));
+        }
+        return fingerprint(hashes.data(), hashes.size());
+    };
+    MultisetFingerprint input_fingerprint = string_fingerprint(input);
+
+    struct Method {
+        std::string name;
+        std::function<void(std::vector<std::string_view> &)> run;
+    };
+    const Method methods[] = {
+        {"std::sort (strings)", [](std::vector<std::string_view> &v) { std::sort(v.begin(), v.end()); }},
+        {"Multikey Quicksort", [](std::vector<std::string_view> &v) { multikeyQuickSort(v); }},
+        {"MSD String Radix Sort (8-byte prefixes)", [](std::vector<std::string_view> &v) { stringRadixSortMSD(v); }},
+        {"Parallel Multikey Quicksort (ThreadPool)", [&](std::vector<std::string_view> &v) {
+            sortStringsParallel(v, pool, StringSortEngine::MultikeyQuicksort);
+        }},
+        {"Parallel MSD String Radix Sort (ThreadPool)", [&](std::vector<std::string_view> &v) {
+            sortStringsParallel(v, pool, StringSortEngine::RadixMSD);
+        }},
+    };
+
+    const PrecisionTimer &timer = PrecisionTimer::instance();
+    for (const auto &method: methods) {
+        std::cout << "Running " << method.name << " (" << input.size() << " strings, " << arena.bytes()
+                << " bytes, " << distributionName(config_.distribution) << ")..." << std::endl;
+
+        for (int i = 0; i < config_.iterations; i++) {
+            std::vector<std::string_view> values = input;
+
+            MemoryRegion memory_region;
+            uint64_t start = timer.now();
+            method.run(values);
+            uint64_t end = timer.now();
+            MemoryUsage memory = memory_region.finish();
+
+            BenchmarkResult result;
+            result.algorithm_name = method.name;
+            result.array_size = input.size();
+            result.distribution = config_.distribution;
+            result.iteration = i + 1;
+            result.time_nanoseconds = timer.elapsedNanoseconds(start, end);
+            result.batch_size = 1;
+            result.segments = 0;
+            result.memory = memory;
+            result.is_sorted = std::is_sorted(values.begin(), values.end());
+            result.is_permutation = string_fingerprint(values) == input_fingerprint;
+
+            results_.push_back(result);
+            reportIteration(result);
+        }
+        std::cout << std::endl;
+    }
+}
+
+namespace {
+
+// Fixed-size record a benchmark child sends back per iteration
+struct IsolatedRecord {
+    int iteration;
+    double time_nanoseconds;
+    int batch_size;
+    bool is_sorted;
+    bool is_permutation;
+    MemoryUsage memory;
+};
+
+} // namespace
+
+void BenchmarkRunner::runAlgorithmIsolated(const AlgorithmInfo &info, int first_iteration, int count) {
+    if (config_.verbose || first_iteration == 1) {
+        std::cout << "Running " << info.name << " (" << config_.array_size << " elements, "
+                << distributionName(config_.distribution) << ", isolated";
+        if (count == 1) {
+            std::cout << ", trial " << first_iteration;
+        }
+        std::cout << ")..." << std::endl;
+    }
+
+    std::vector<int> cpus;
+    if (config_.cpu_set) {
+        parseCpuSet(config_.cpu_set, cpus);
+    }
+
+    std::string output;
+    bool ok = runInChild([&](int out_fd) {
+        if (!pinToCpus(cpus)) {
+            std::cerr << "  WARNING: Could not pin to CPU set " << config_.cpu_set << std::endl;
+        }
+        prefaultHeap(2 * config_.array_size * sizeof(int));
+
+        // Threads do not survive fork(), so the child needs its own pool
+        ThreadPool pool(config_.threadpool_size);
+        SortFunction sort_function = info.factory(SortEnvironment{pool, config_.thread_count, config_.reuse_scratch});
+
+        for (int i = 0; i < count; i++) {
+            BenchmarkResult result = measureIteration(info.name, sort_function, first_iteration + i);
+            IsolatedRecord record{
+                result.iteration, result.time_nanoseconds, result.batch_size,
+                result.is_sorted, result.is_permutation, result.memory
+            };
+            if (!writeAll(out_fd, &record, sizeof(record))) {
+                break;
+            }
+        }
+    }, output);
+
+    if (!ok || output.size() != count * sizeof(IsolatedRecord)) {
+        std::cerr << "  ERROR: Isolated run of " << info.name << " failed" << std::endl;
+        return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        IsolatedRecord record;
+        std::memcpy(&record, output.data() + i * sizeof(IsolatedRecord), sizeof(record));
+
+        BenchmarkResult result;
+        result.algorithm_name = info.name;
+        result.array_size = config_.array_size;
+        result.distribution = config_.distribution;
+        result.iteration = record.iteration;
+        result.time_nanoseconds = record.time_nanoseconds;
+        result.batch_size = record.batch_size;
+        result.is_sorted = record.is_sorted;
+        result.is_permutation = record.is_permutation;
+        result.segments = 0;
+        result.memory = record.memory;
+
+        results_.push_back(result);
+        reportIteration(result);
+    }
+
+    if (count > 1) {
+        std::cout << std::endl;
+    }
+}
+
+std::vector<BenchmarkCase> BenchmarkRunner::cases() const {
+    std::vector<BenchmarkCase> all_cases;
+    for (const auto &result: results_) {
+        BenchmarkCase benchmark_case{result.algorithm_name, result.array_size, result.distribution};
+        if (std::find(all_cases.begin(), all_cases.end(), benchmark_case) == all_cases.end()) {
+            all_cases.push_back(benchmark_case);
+        }
+    }
+    return all_cases;
+}
+
+std::vector<double> BenchmarkRunner::samplesFor(const BenchmarkCase &benchmark_case) const {
+    std::vector<double> samples;
+    for (const auto &result: results_) {
+        if (result.algorithm_name == benchmark_case.algorithm_name &&
+            result.array_size == benchmark_case.array_size &&
+            result.distribution == benchmark_case.distribution) {
+            samples.push_back(result.time_nanoseconds);
+        }
+    }
+    return samples;
+}
+
+AlgorithmStats BenchmarkRunner::calculateStats(const BenchmarkCase &benchmark_case) const {
     AlgorithmStats stats;
-    stats.algorithm_name = algorithm_name;
+    stats.algorithm_name = benchmark_case.algorithm_name;
     stats.total_runs = 0;
     stats.successful_sorts = 0;
+    stats.avg_allocations = 0.0;
+    stats.avg_bytes_allocated = 0.0;
+    stats.avg_scratch_allocations = 0.0;
+    stats.avg_scratch_bytes_allocated = 0.0;
+    stats.segments_per_second = 0.0;
+    stats.max_peak_heap_bytes = 0;
+    stats.max_peak_rss_delta_bytes = 0;
 
     std::vector<double> times;
 
     // Collect all times for this algorithm
     for (const auto &result: results_) {
-        if (result.algorithm_name == algorithm_name) {
-            times.push_back(result.time_microseconds);
+        if (result.algorithm_name == benchmark_case.algorithm_name &&
+            result.array_size == benchmark_case.array_size &&
+            result.distribution == benchmark_case.distribution) {
+            times.push_back(result.time_nanoseconds);
             stats.total_runs++;
-            if (result.is_sorted) {
+            if (result.is_sorted && result.is_permutation) {
                 stats.successful_sorts++;
             }
+            stats.avg_allocations += result.memory.allocation_count;
+            stats.avg_bytes_allocated += result.memory.bytes_allocated;
+            stats.avg_scratch_allocations += result.memory.scratch_allocation_count;
+            stats.avg_scratch_bytes_allocated += result.memory.scratch_bytes_allocated;
+            stats.segments_per_second += static_cast<double>(result.segments);
+            stats.max_peak_heap_bytes = std::max(stats.max_peak_heap_bytes, result.memory.peak_heap_bytes);
+            stats.max_peak_rss_delta_bytes = std::max(stats.max_peak_rss_delta_bytes,
+                                                      result.memory.peak_rss_delta_bytes);
         }
     }
 
     if (times.empty()) {
-        stats.avg_time_microseconds = 0.0;
-        stats.min_time_microseconds = 0.0;
-        stats.max_time_microseconds = 0.0;
-        stats.std_dev_microseconds = 0.0;
+        stats.avg_time_nanoseconds = 0.0;
+        stats.min_time_nanoseconds = 0.0;
+        stats.max_time_nanoseconds = 0.0;
+        stats.std_dev_nanoseconds = 0.0;
         return stats;
     }
 
     // Calculate statistics
-    stats.min_time_microseconds = *std::min_element(times.begin(), times.end());
-    stats.max_time_microseconds = *std::max_element(times.begin(), times.end());
+    stats.avg_allocations /= times.size();
+    stats.avg_bytes_allocated /= times.size();
+    stats.avg_scratch_allocations /= times.size();
+    stats.avg_scratch_bytes_allocated /= times.size();
+    stats.min_time_nanoseconds = *std::min_element(times.begin(), times.end());
+    stats.max_time_nanoseconds = *std::max_element(times.begin(), times.end());
 
     double sum = 0.0;
     for (double time: times) {
         sum += time;
     }
-    stats.avg_time_microseconds = sum / times.size();
+    stats.avg_time_nanoseconds = sum / times.size();
+    if (stats.avg_time_nanoseconds > 0.0) {
+        stats.segments_per_second = stats.segments_per_second / times.size() / (stats.avg_time_nanoseconds / 1e9);
+    }
 
     // Calculate standard deviation
     double variance_sum = 0.0;
     for (double time: times) {
-        double diff = time - stats.avg_time_microseconds;
+        double diff = time - stats.avg_time_nanoseconds;
         variance_sum += diff * diff;
     }
-    stats.std_dev_microseconds = std::sqrt(variance_sum / times.size());
+    stats.std_dev_nanoseconds = std::sqrt(variance_sum / times.size());
 
     return stats;
 }
@@ -127,54 +801,151 @@ void BenchmarkRunner::exportToCSV() const {
     }
 
     // Write CSV header
-    file << "Algorithm,ArraySize,Iteration,TimeMicroseconds,TimeMilliseconds,IsSorted\n";
+    file << "Algorithm,ArraySize,Distribution,Iteration,TimeNanoseconds,TimeMicroseconds,TimeMilliseconds,"
+            << "BatchSize,IsSorted,IsPermutation,"
+            << "Allocations,BytesAllocated,ScratchAllocations,ScratchBytesAllocated,PeakHeapBytes,PeakRSSDeltaBytes\n";
 
     // Write data rows
     for (const auto &result: results_) {
         file << result.algorithm_name << ","
                 << result.array_size << ","
+                << distributionName(result.distribution) << ","
                 << result.iteration << ","
-                << std::fixed << std::setprecision(2) << result.time_microseconds << ","
-                << std::fixed << std::setprecision(2) << result.time_microseconds / 1000.0 << ","
-                << (result.is_sorted ? "true" : "false") << "\n";
+                << std::fixed << std::setprecision(1) << result.time_nanoseconds << ","
+                << std::fixed << std::setprecision(3) << result.time_nanoseconds / 1000.0 << ","
+                << std::fixed << std::setprecision(6) << result.time_nanoseconds / 1000000.0 << ","
+                << result.batch_size << ","
+                << (result.is_sorted ? "true" : "false") << ","
+                << (result.is_permutation ? "true" : "false") << ","
+                << result.memory.allocation_count << ","
+                << result.memory.bytes_allocated << ","
+                << result.memory.scratch_allocation_count << ","
+                << result.memory.scratch_bytes_allocated << ","
+                << result.memory.peak_heap_bytes << ","
+                << result.memory.peak_rss_delta_bytes << "\n";
+    }
+
+    file.close();
+    std::cout << "Results exported to " << config_.output_file << std::endl;
+}
+
+void BenchmarkRunner::exportToJSON() const {
+    std::ofstream file(config_.output_file);
+
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open output file " << config_.output_file << std::endl;
+        return;
+    }
+
+    file << "[\n";
+    for (size_t i = 0; i < results_.size(); i++) {
+        const BenchmarkResult &result = results_[i];
+        file << "  {\"algorithm\": \"" << jsonEscape(result.algorithm_name) << "\", "
+                << "\"array_size\": " << result.array_size << ", "
+                << "\"distribution\": \"" << distributionName(result.distribution) << "\", "
+                << "\"iteration\": " << result.iteration << ", "
+                << "\"time_nanoseconds\": " << std::fixed << std::setprecision(1) << result.time_nanoseconds << ", "
+                << "\"batch_size\": " << result.batch_size << ", "
+                << "\"is_sorted\": " << (result.is_sorted ? "true" : "false") << ", "
+                << "\"is_permutation\": " << (result.is_permutation ? "true" : "false") << ", "
+                << "\"allocations\": " << result.memory.allocation_count << ", "
+                << "\"bytes_allocated\": " << result.memory.bytes_allocated << ", "
+                << "\"scratch_allocations\": " << result.memory.scratch_allocation_count << ", "
+                << "\"scratch_bytes_allocated\": " << result.memory.scratch_bytes_allocated << ", "
+                << "\"peak_heap_bytes\": " << result.memory.peak_heap_bytes << ", "
+                << "\"peak_rss_delta_bytes\": " << result.memory.peak_rss_delta_bytes << "}"
+                << (i + 1 < results_.size() ? "," : "") << "\n";
     }
+    file << "]\n";
 
     file.close();
     std::cout << "Results exported to " << config_.output_file << std::endl;
 }
 
+void BenchmarkRunner::exportResults() const {
+    switch (config_.output_format) {
+        case OutputFormat::CSV:
+            exportToCSV();
+            break;
+        case OutputFormat::JSON:
+            exportToJSON();
+            break;
+        case OutputFormat::None:
+            break;
+    }
+}
+
 void BenchmarkRunner::printSummary() const {
     std::cout << "\n========================================" << std::endl;
     std::cout << "BENCHMARK SUMMARY" << std::endl;
     std::cout << "========================================" << std::endl;
-    std::cout << "Array size: " << config_.array_size << " elements" << std::endl;
     std::cout << "Iterations per algorithm: " << config_.iterations << std::endl;
     std::cout << "========================================\n" << std::endl;
 
-    // Get unique algorithm names
-    std::vector<std::string> algorithm_names;
-    for (const auto &result: results_) {
-        if (std::find(algorithm_names.begin(), algorithm_names.end(), result.algorithm_name) == algorithm_names.end()) {
-            algorithm_names.push_back(result.algorithm_name);
+    // Group cases by input so every sweep point gets its own comparison
+    std::vector<BenchmarkCase> all_cases = cases();
+    std::vector<BenchmarkCase> inputs;
+    for (const auto &benchmark_case: all_cases) {
+        bool seen = std::any_of(inputs.begin(), inputs.end(), [&](const BenchmarkCase &input) {
+            return input.array_size == benchmark_case.array_size &&
+                   input.distribution == benchmark_case.distribution;
+        });
+        if (!seen) {
+            inputs.push_back(benchmark_case);
         }
     }
 
+    for (const auto &input: inputs) {
+        std::vector<BenchmarkCase> input_cases;
+        for (const auto &benchmark_case: all_cases) {
+            if (benchmark_case.array_size == input.array_size &&
+                benchmark_case.distribution == input.distribution) {
+                input_cases.push_back(benchmark_case);
+            }
+        }
+        printInputSummary(input_cases);
+    }
+}
+
+void BenchmarkRunner::printInputSummary(const std::vector<BenchmarkCase> &input_cases) const {
+    std::cout << "Array size: " << input_cases.front().array_size << " elements ("
+            << distributionName(input_cases.front().distribution) << ")" << std::endl;
+    std::cout << "----------------------------------------" << std::endl;
+
     // Calculate and display statistics for each algorithm
     std::vector<AlgorithmStats> all_stats;
-    for (const auto &name: algorithm_names) {
-        AlgorithmStats stats = calculateStats(name);
+    for (const auto &benchmark_case: input_cases) {
+        AlgorithmStats stats = calculateStats(benchmark_case);
         all_stats.push_back(stats);
 
-        std::cout << name << ":" << std::endl;
-        std::cout << "  Average: " << std::fixed << std::setprecision(2)
-                << stats.avg_time_microseconds / 1000.0 << " ms" << std::endl;
-        std::cout << "  Min:     " << std::fixed << std::setprecision(2)
-                << stats.min_time_microseconds / 1000.0 << " ms" << std::endl;
-        std::cout << "  Max:     " << std::fixed << std::setprecision(2)
-                << stats.max_time_microseconds / 1000.0 << " ms" << std::endl;
-        std::cout << "  StdDev:  " << std::fixed << std::setprecision(2)
-                << stats.std_dev_microseconds / 1000.0 << " ms" << std::endl;
+        std::cout << benchmark_case.algorithm_name << ":" << std::endl;
+        std::cout << "  Average: " << formatDuration(stats.avg_time_nanoseconds) << std::endl;
+        std::cout << "  Min:     " << formatDuration(stats.min_time_nanoseconds) << std::endl;
+        std::cout << "  Max:     " << formatDuration(stats.max_time_nanoseconds) << std::endl;
+        std::cout << "  StdDev:  " << formatDuration(stats.std_dev_nanoseconds) << std::endl;
         std::cout << "  Success: " << stats.successful_sorts << "/" << stats.total_runs << std::endl;
+        bool file_mode = config_.mode == BenchmarkMode::External || config_.mode == BenchmarkMode::Mapped;
+        if (file_mode && stats.avg_time_nanoseconds > 0.0) {
+            size_t key_bytes = config_.mode == BenchmarkMode::Mapped ? config_.key_bits / 8 : sizeof(int);
+            double megabytes = benchmark_case.array_size * key_bytes / (1024.0 * 1024.0);
+            std::cout << "  Throughput: " << std::fixed << std::setprecision(1)
+                    << megabytes / (stats.avg_time_nanoseconds / 1e9) << " MB/s" << std::endl;
+        }
+        if (stats.segments_per_second > 0.0) {
+            std::cout << "  Throughput: " << std::fixed << std::setprecision(2)
+                    << stats.segments_per_second / 1e6 << " M segments/s" << std::endl;
+        }
+        // Scratch arena growth is reported apart from everything else (task
+        // submission, futures, result buffers), which reuse cannot remove
+        std::cout << "  Allocs:  " << std::fixed << std::setprecision(0) << stats.avg_allocations
+                << " (" << std::setprecision(2) << stats.avg_bytes_allocated / (1024.0 * 1024.0)
+                << " MB) per sort; scratch " << std::setprecision(0) << stats.avg_scratch_allocations
+                << " (" << std::setprecision(2) << stats.avg_scratch_bytes_allocated / (1024.0 * 1024.0)
+                << " MB), other " << std::setprecision(0)
+                << stats.avg_allocations - stats.avg_scratch_allocations << std::endl;
+        std::cout << "  Peak heap: " << std::fixed << std::setprecision(2)
+                << stats.max_peak_heap_bytes / (1024.0 * 1024.0) << " MB, peak RSS: +"
+                << stats.max_peak_rss_delta_bytes / (1024.0 * 1024.0) << " MB" << std::endl;
         std::cout << std::endl;
     }
 
@@ -184,32 +955,32 @@ void BenchmarkRunner::printSummary() const {
         std::cout << "SPEEDUP ANALYSIS" << std::endl;
         std::cout << "========================================" << std::endl;
 
-        // Find single-threaded and multi-threaded merge sort
-        AlgorithmStats *single_threaded = nullptr;
-        AlgorithmStats *multi_threaded = nullptr;
+        // Report every declared speedup relationship whose baseline ran on this input
+        for (const auto &stats: all_stats) {
+            const AlgorithmInfo *info = AlgorithmRegistry::instance().findByName(stats.algorithm_name);
+            if (!info || info->speedup_baseline.empty()) continue;
 
-        for (auto &stats: all_stats) {
-            if (stats.algorithm_name.find("Single-Threaded Merge Sort") != std::string::npos) {
-                single_threaded = &stats;
-            } else if (stats.algorithm_name.find("Multi-Threaded Merge Sort") != std::string::npos) {
-                multi_threaded = &stats;
-            }
-        }
+            const AlgorithmInfo *baseline_info = AlgorithmRegistry::instance().findById(info->speedup_baseline);
+            if (!baseline_info) continue;
+
+            auto baseline_stats = std::find_if(all_stats.begin(), all_stats.end(), [&](const AlgorithmStats &other) {
+                return other.algorithm_name == baseline_info->name;
+            });
+            if (baseline_stats == all_stats.end()) continue;
 
-        if (single_threaded && multi_threaded) {
-            double speedup = single_threaded->avg_time_microseconds / multi_threaded->avg_time_microseconds;
-            std::cout << "Multi-threaded vs Single-threaded Merge Sort:" << std::endl;
+            double speedup = baseline_stats->avg_time_nanoseconds / stats.avg_time_nanoseconds;
+            std::cout << stats.algorithm_name << " vs " << baseline_info->name << ":" << std::endl;
             std::cout << "  Speedup: " << std::fixed << std::setprecision(2) << speedup << "x" << std::endl;
             std::cout << std::endl;
         }
 
         // Compare all algorithms to fastest
-        double fastest_time = all_stats[0].avg_time_microseconds;
+        double fastest_time = all_stats[0].avg_time_nanoseconds;
         std::string fastest_name = all_stats[0].algorithm_name;
 
         for (const auto &stats: all_stats) {
-            if (stats.avg_time_microseconds < fastest_time) {
-                fastest_time = stats.avg_time_microseconds;
+            if (stats.avg_time_nanoseconds < fastest_time) {
+                fastest_time = stats.avg_time_nanoseconds;
                 fastest_name = stats.algorithm_name;
             }
         }
@@ -217,10 +988,296 @@ void BenchmarkRunner::printSummary() const {
         std::cout << "Fastest algorithm: " << fastest_name << std::endl;
         std::cout << "Relative performance:" << std::endl;
         for (const auto &stats: all_stats) {
-            double ratio = stats.avg_time_microseconds / fastest_time;
+            double ratio = stats.avg_time_nanoseconds / fastest_time;
             std::cout << "  " << stats.algorithm_name << ": "
                     << std::fixed << std::setprecision(2) << ratio << "x slower" << std::endl;
         }
         std::cout << std::endl;
     }
-}
\ No newline at end of file
+}
+
+bool BenchmarkRunner::saveBaseline(const std::string &path) const {
+    Baseline baseline;
+    baseline.machine_tag = currentMachineTag();
+
+    for (const auto &benchmark_case: cases()) {
+        baseline.entries.push_back({
+            benchmark_case.algorithm_name,
+            benchmark_case.array_size,
+            distributionName(benchmark_case.distribution),
+            samplesFor(benchmark_case)
+        });
+    }
+
+    if (!::saveBaseline(path, baseline)) {
+        return false;
+    }
+
+    std::cout << "Baseline saved to " << path << " (" << baseline.machine_tag << ")" << std::endl;
+    return true;
+}
+
+BaselineComparison BenchmarkRunner::compareToBaseline(const std::string &path) const {
+    Baseline baseline;
+    if (!loadBaseline(path, baseline)) {
+        return BaselineComparison::Error;
+    }
+
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "REGRESSION CHECK" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Baseline: " << path << std::endl;
+    std::cout << "Threshold: " << std::fixed << std::setprecision(1)
+            << config_.regression_threshold * 100.0 << "% slowdown at p < "
+            << std::setprecision(3) << config_.significance_level << std::endl;
+
+    std::string machine_tag = currentMachineTag();
+    if (baseline.machine_tag != machine_tag) {
+        std::cerr << "WARNING: Baseline was recorded on " << baseline.machine_tag
+                << ", this run is on " << machine_tag << std::endl;
+    }
+    std::cout << std::endl;
+
+    bool regression = false;
+    for (const auto &benchmark_case: cases()) {
+        const std::string &name = benchmark_case.algorithm_name;
+        const char *distribution = distributionName(benchmark_case.distribution);
+        const BaselineEntry *entry = baseline.find(name, benchmark_case.array_size, distribution);
+        if (!entry || entry->samples.empty()) {
+            std::cout << name << ": no baseline at " << benchmark_case.array_size << " elements ("
+                    << distribution << ")" << std::endl;
+            continue;
+        }
+
+        std::vector<double> current = samplesFor(benchmark_case);
+        double base_median = median(entry->samples);
+        double current_median = median(current);
+        double delta = base_median > 0.0 ? (current_median - base_median) / base_median : 0.0;
+        MannWhitneyResult test = mannWhitneyU(current, entry->samples);
+
+        bool significant = test.p_value < config_.significance_level;
+        const char *verdict = "no change";
+        if (significant && delta > config_.regression_threshold) {
+            verdict = "REGRESSION";
+            regression = true;
+        } else if (significant && delta > 0.0) {
+            verdict = "slower (below threshold)";
+        } else if (significant && delta < 0.0) {
+            verdict = "faster";
+        }
+
+        std::cout << name << " [" << benchmark_case.array_size << ", " << distribution << "]:" << std::endl;
+        std::cout << "  Median:  " << formatDuration(base_median) << " -> "
+                << formatDuration(current_median) << std::endl;
+        std::cout << "  Delta:   " << std::showpos << std::fixed << std::setprecision(2)
+                << delta * 100.0 << "%" << std::noshowpos << std::endl;
+        std::cout << "  p-value: " << std::fixed << std::setprecision(4) << test.p_value
+                << " (U = " << std::setprecision(1) << test.u << ")" << std::endl;
+        std::cout << "  Verdict: " << verdict << std::endl;
+        std::cout << std::endl;
+    }
+
+    if (regression) {
+        std::cerr << "Performance regression detected against " << path << std::endl;
+    }
+    return regression ? BaselineComparison::Regression : BaselineComparison::NoRegression;
+}
+
+// ============================================
+// Input generation
+// ============================================
+
+namespace {
+
+// Key of rank i among n ascending keys: i itself while it fits in an int,
+// otherwise i scaled onto [0, INT_MAX] so arrays past 2^31 stay ascending
+int rankKey(size_t i, size_t n) {
+    constexpr auto int_max = static_cast<size_t>(std::numeric_limits<int>::max());
+    if (n <= int_max) return static_cast<int>(i);
+    return static_cast<int>(static_cast<double>(i) * (static_cast<double>(int_max) / static_cast<double>(n)));
+}
+
+} // namespace
+
+std::vector<int> generateArray(size_t array_size, Distribution distribution, unsigned int seed) {
+    std::vector<int> arr(array_size);
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<> dis(1, 1000000);
+
+    switch (distribution) {
+        case Distribution::Random:
+            for (size_t i = 0; i < array_size; i++) {
+                arr[i] = dis(gen);
+            }
+            break;
+
+        case Distribution::Sorted:
+        case Distribution::Reversed:
+        case Distribution::NearlySorted:
+            for (size_t i = 0; i < array_size; i++) {
+                arr[i] = rankKey(i, array_size);
+            }
+            if (distribution == Distribution::Reversed) {
+                std::reverse(arr.begin(), arr.end());
+            } else if (distribution == Distribution::NearlySorted && array_size > 1) {
+                // Swap ~1% of the elements with a random partner
+                std::uniform_int_distribution<size_t> pos(0, array_size - 1);
+                for (size_t i = 0; i < array_size / 100 + 1; i++) {
+                    std::swap(arr[pos(gen)], arr[pos(gen)]);
+                }
+            }
+            break;
+
+        case Distribution::FewUnique: {
+            std::uniform_int_distribution<> few(1, 16);
+            for (size_t i = 0; i < array_size; i++) {
+                arr[i] = few(gen);
+            }
+            break;
+        }
+
+        case Distribution::OrganPipe:
+            for (size_t i = 0; i < array_size; i++) {
+                arr[i] = rankKey(std::min(i, array_size - 1 - i), array_size);
+            }
+            break;
+
+        case Distribution::SortedAppend: {
+            size_t sorted_part = array_size - array_size / 10;
+            for (size_t i = 0; i < array_size; i++) {
+                arr[i] = i < sorted_part ? rankKey(i, array_size) : dis(gen);
+            }
+            break;
+        }
+
+        case Distribution::CommonPrefix: {
+            // Only the low 16 bits vary, so the leading radix digits are all equal
+            std::uniform_int_distribution<> low(0, 0xFFFF);
+            for (size_t i = 0; i < array_size; i++) {
+                arr[i] = 0x2A5A0000 | low(gen);
+            }
+            break;
+        }
+    }
+
+    return arr;
+}
+
+StringArena generateStrings(size_t count, Distribution distribution, unsigned int seed) {
+    StringArena arena;
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> letter('a', 'z');
+    auto random_word = [&](size_t min_length, size_t max_length) {
+        std::string word(std::uniform_int_distribution<size_t>(min_length, max_length)(gen), ' ');
+        for (char &c: word) {
+            c = static_cast<char>(letter(gen));
+        }
+        return word;
+    };
+
+    switch (distribution) {
+        case Distribution::Random:
+            arena.reserve(count, count * 16);
+            for (size_t i = 0; i < count; i++) {
+                arena.append(random_word(1, 30));
+            }
+            break;
+
+        case Distribution::FewUnique: {
+            std::vector<std::string> words(16);
+            for (auto &word: words) {
+                word = random_word(8, 24);
+            }
+            std::uniform_int_distribution<size_t> pick(0, words.size() - 1);
+            arena.reserve(count, count * 16);
+            for (size_t i = 0; i < count; i++) {
+                arena.append(words[pick(gen)]);
+            }
+            break;
+        }
+
+        case Distribution::CommonPrefix: {
+            // Every string spends its first 42 bytes on the same prefix
+            constexpr std::string_view prefix = "https://data.example.com/catalog/v2/items/";
+            std::uniform_int_distribution<> item(1, 1000000);
+            std::string url;
+            arena.reserve(count, count * (prefix.size() + 16));
+            for (size_t i = 0; i < count; i++) {
+                url = prefix;
+                url += random_word(4, 12);
+                url += '/';
+                url += std::to_string(item(gen));
+                arena.append(url);
+            }
+            break;
+        }
+
+        case Distribution::Sorted:
+        case Distribution::Reversed:
+        case Distribution::NearlySorted:
+        case Distribution::OrganPipe:
+        case Distribution::SortedAppend: {
+            // Flipping the sign bit makes the zero-padded decimal order the key order
+            std::vector<int> keys = generateArray(count, distribution, seed);
+            char id[16];
+            arena.reserve(count, count * 13);
+            for (int key: keys) {
+                int length = std::snprintf(id, sizeof(id), "id-%010u", static_cast<unsigned>(key) ^ 0x80000000u);
+                arena.append(std::string_view(id, static_cast<size_t>(length)));
+            }
+            break;
+        }
+    }
+
+    return arena;
+}
+
+std::vector<size_t> generateSegmentOffsets(size_t total, size_t min_length, size_t max_length, unsigned int seed) {
+    std::mt19937 gen(seed ^ 0x5e9u);
+    std::uniform_int_distribution<size_t> length(std::max<size_t>(min_length, 1), std::max(min_length, max_length));
+
+    std::vector<size_t> offsets{0};
+    while (offsets.back() < total) {
+        offsets.push_back(std::min(total, offsets.back() + length(gen)));
+    }
+    return offsets;
+}
+
+namespace {
+
+struct DistributionName {
+    Distribution distribution;
+    const char *name;
+};
+
+constexpr DistributionName DISTRIBUTION_NAMES[] = {
+    {Distribution::Random, "random"},
+    {Distribution::Sorted, "sorted"},
+    {Distribution::Reversed, "reversed"},
+    {Distribution::NearlySorted, "nearly-sorted"},
+    {Distribution::FewUnique, "few-unique"},
+    {Distribution::OrganPipe, "organ-pipe"},
+    {Distribution::SortedAppend, "sorted-append"},
+    {Distribution::CommonPrefix, "common-prefix"},
+};
+
+} // namespace
+
+const char *distributionName(Distribution distribution) {
+    for (const auto &entry: DISTRIBUTION_NAMES) {
+        if (entry.distribution == distribution) {
+            return entry.name;
+        }
+    }
+    return "unknown";
+}
+
+bool parseDistribution(const std::string &name, Distribution &distribution) {
+    for (const auto &entry: DISTRIBUTION_NAMES) {
+        if (name == entry.name) {
+            distribution = entry.distribution;
+            return true;
+        }
+    }
+    return false;
+}
@@ -5,25 +5,58 @@
 #include <vector>
 #include <functional>
 #include "config.h"
+#include "memory_tracker.h"
+#include "string_sort.h"
+
+struct AlgorithmInfo;
+class ThreadPool;
+
+// Outcome of checking a run against a stored baseline
+enum class BaselineComparison {
+    NoRegression,
+    Regression,    // some algorithm is significantly slower than the threshold allows
+    Error          // the baseline file could not be read
+};
 
 // Structure to hold benchmark results for a single run
 struct BenchmarkResult {
     std::string algorithm_name;
     size_t array_size;
+    Distribution distribution;
     int iteration;
-    double time_microseconds;
+    double time_nanoseconds;    // per sort; averaged over the batch for small inputs
+    int batch_size;             // sorts timed together in one region
     bool is_sorted;
+    bool is_permutation;        // output holds exactly the input's elements
+    size_t segments;            // segments per call in segmented mode, 0 otherwise
+    MemoryUsage memory;         // per sort, except peaks which cover the whole batch
+};
+
+// One (algorithm, array size, distribution) cell of a benchmark sweep
+struct BenchmarkCase {
+    std::string algorithm_name;
+    size_t array_size;
+    Distribution distribution;
+
+    bool operator==(const BenchmarkCase &other) const = default;
 };
 
 // Structure to hold statistical summary for an algorithm
 struct AlgorithmStats {
     std::string algorithm_name;
-    double avg_time_microseconds;
-    double min_time_microseconds;
-    double max_time_microseconds;
-    double std_dev_microseconds;
+    double avg_time_nanoseconds;
+    double min_time_nanoseconds;
+    double max_time_nanoseconds;
+    double std_dev_nanoseconds;
     int successful_sorts;
     int total_runs;
+    double avg_allocations;
+    double avg_bytes_allocated;
+    double avg_scratch_allocations;         // part of avg_allocations taken by scratch arenas
+    double avg_scratch_bytes_allocated;
+    double segments_per_second;     // segmented mode only
+    size_t max_peak_heap_bytes;
+    size_t max_peak_rss_delta_bytes;
 };
 
 // Benchmark runner class
@@ -31,25 +64,108 @@ class BenchmarkRunner {
 public:
     explicit BenchmarkRunner(const BenchmarkConfig &config);
 
+    // Change the input used by subsequent runAlgorithm calls (for size/distribution sweeps)
+    void setArraySize(size_t array_size);
+
+    void setDistribution(Distribution distribution);
+
     // Run a single algorithm benchmark
     void runAlgorithm(
         const std::string &algorithm_name,
         std::function<void(std::vector<int> &)> sort_function
     );
 
+    // Run a segmented sort over a buffer of array_size elements split into
+    // segments of config.segment_min..segment_max elements
+    void runSegmented(
+        const std::string &algorithm_name,
+        const std::function<void(std::vector<int> &, const std::vector<size_t> &)> &sort_function
+    );
+
+    // Time topK, partialSortParallel and nthElementParallel (and their std:: and
+    // full-sort counterparts) for k = config.select_k on the current input
+    void runSelection(ThreadPool &pool);
+
+    // Sort config.external_input (or a generated file of array_size keys) file-to-file
+    // with externalSort under config.memory_cap, verifying the output by streaming it back
+    void runExternalSort(ThreadPool &pool);
+
+    // Sort copies of config.external_input (or a generated file of array_size keys of
+    // config.key_bits) in place through a memory mapping and by read-sort-write
+    void runMappedSort(ThreadPool &pool);
+
+    // Sort the current input with distributedSort over config.distributed_workers
+    // worker processes, reporting the time of each phase
+    void runDistributedSort();
+
+    // Sort array_size generated strings of the current distribution with
+    // std::sort, multikeyQuickSort, stringRadixSortMSD and sortStringsParallel
+    void runStringSort(ThreadPool &pool);
+
+    // Run iterations [first_iteration, first_iteration + count) of a registered algorithm
+    // in a forked child process pinned to config.cpu_set, with its own ThreadPool
+    void runAlgorithmIsolated(const AlgorithmInfo &info, int first_iteration, int count);
+
     // Export all results to CSV
     void exportToCSV() const;
 
+    // Export all results as a JSON array of per-iteration records
+    void exportToJSON() const;
+
+    // Export in the configured output format
+    void exportResults() const;
+
     // Print summary statistics
     void printSummary() const;
 
+    // Save per-iteration samples as a machine-tagged JSON baseline
+    bool saveBaseline(const std::string &path) const;
+
+    // Compare this run against a stored baseline: Regression if any algorithm is
+    // significantly slower than the baseline by more than the configured
+    // threshold, Error if the baseline is missing or malformed
+    BaselineComparison compareToBaseline(const std::string &path) const;
+
 private:
     BenchmarkConfig config_;
     std::vector<BenchmarkResult> results_;
 
-    std::vector<int> generateRandomArray() const;
+    BenchmarkResult measureIteration(
+        const std::string &algorithm_name,
+        const std::function<void(std::vector<int> &)> &sort_function,
+        int iteration
+    ) const;
+
+    void reportIteration(const BenchmarkResult &result) const;
+
+    // Number of sorts to time together for the current array size
+    int batchSize() const;
 
-    AlgorithmStats calculateStats(const std::string &algorithm_name) const;
+    AlgorithmStats calculateStats(const BenchmarkCase &benchmark_case) const;
+
+    std::vector<BenchmarkCase> cases() const;
+
+    void printInputSummary(const std::vector<BenchmarkCase> &input_cases) const;
+
+    std::vector<double> samplesFor(const BenchmarkCase &benchmark_case) const;
 };
 
+// Generate an input array of the given size and pattern
+std::vector<int> generateArray(size_t array_size, Distribution distribution, unsigned int seed);
+
+// Generate `count` strings of the given pattern: random lower-case words,
+// URLs under one long shared prefix (CommonPrefix), 16 distinct words
+// (FewUnique), or fixed-width identifiers carrying the order of generateArray
+// for the other patterns
+StringArena generateStrings(size_t count, Distribution distribution, unsigned int seed);
+
+// Random segment boundaries over [0, total): offsets.front() == 0, offsets.back() == total
+std::vector<size_t> generateSegmentOffsets(size_t total, size_t min_length, size_t max_length, unsigned int seed);
+
+// Stable lower-case name of a distribution ("random", "nearly-sorted", ...)
+const char *distributionName(Distribution distribution);
+
+// Parse a distribution name; returns false if it is unknown
+bool parseDistribution(const std::string &name, Distribution &distribution);
+
 #endif // BENCHMARK_H
\ No newline at end of file
@@ -0,0 +1,462 @@
+#include "cli.h"
+#include "benchmark.h"
+#include "isolation.h"
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+
+// ============================================
+// Value parsers
+// ============================================
+
+namespace {
+
+std::vector<std::string> splitList(const std::string &value) {
+    std::vector<std::string> items;
+    std::stringstream stream(value);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+// A plain integer, optionally followed by K/M/G for unit, unit^2 or unit^3.
+// Values that do not fit in size_t are rejected.
+bool parseScaled(const std::string &text, size_t unit, size_t &value) {
+    if (text.empty() || !std::isdigit(static_cast<unsigned char>(text[0]))) return false;
+
+    char *end = nullptr;
+    errno = 0;
+    unsigned long long parsed = std::strtoull(text.c_str(), &end, 10);
+    if (errno == ERANGE) return false;
+
+    std::string suffix(end);
+    size_t multiplier = 1;
+    if (suffix == "K" || suffix == "k") multiplier = unit;
+    else if (suffix == "M" || suffix == "m") multiplier = unit * unit;
+    else if (suffix == "G" || suffix == "g") multiplier = unit * unit * unit;
+    else if (!suffix.empty()) return false;
+    if (parsed > SIZE_MAX / multiplier) return false;
+
+    value = static_cast<size_t>(parsed) * multiplier;
+    return true;
+}
+
+// Accepts plain integers and K/M/G (decimal) suffixes, e.g. "250K" or "1M"
+bool parseCount(const std::string &text, size_t &value) {
+    return parseScaled(text, 1000, value);
+}
+
+bool parseInt(const std::string &text, int &value) {
+    size_t parsed = 0;
+    if (!parseCount(text, parsed) || parsed > 0x7fffffff) return false;
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+bool parseDouble(const std::string &text, double &value) {
+    char *end = nullptr;
+    value = std::strtod(text.c_str(), &end);
+    return !text.empty() && *end == '\0';
+}
+
+// Like parseCount, but K/M/G are binary (KiB, MiB, GiB), as befits a memory size
+bool parseBytes(const std::string &text, size_t &value) {
+    return parseScaled(text, 1024, value);
+}
+
+// A size item is either "N" or a sweep "START:END[:xFACTOR|:+STEP]" (default x10)
+bool parseSizes(const std::string &text, std::vector<size_t> &sizes) {
+    for (const auto &item: splitList(text)) {
+        size_t first_colon = item.find(':');
+        if (first_colon == std::string::npos) {
+            size_t size = 0;
+            if (!parseCount(item, size)) return false;
+            sizes.push_back(size);
+            continue;
+        }
+
+        size_t second_colon = item.find(':', first_colon + 1);
+        size_t start = 0;
+        size_t end = 0;
+        if (!parseCount(item.substr(0, first_colon), start) ||
+            !parseCount(item.substr(first_colon + 1, second_colon - first_colon - 1), end) ||
+            start == 0 || end < start) {
+            return false;
+        }
+
+        std::string step = second_colon == std::string::npos ? "x10" : item.substr(second_colon + 1);
+        size_t amount = 0;
+        if (step.size() < 2 || !parseCount(step.substr(1), amount) || amount == 0) return false;
+
+        if (step[0] == 'x') {
+            if (amount < 2) return false;
+            for (size_t size = start; size <= end; size *= amount) {
+                sizes.push_back(size);
+                if (size > end / amount) break;
+            }
+        } else if (step[0] == '+') {
+            for (size_t size = start; size <= end; size += amount) {
+                sizes.push_back(size);
+                if (size > end - amount) break;
+            }
+        } else {
+            return false;
+        }
+    }
+    return !sizes.empty();
+}
+
+bool parseBenchmarkMode(const std::string &text, BenchmarkMode &mode) {
+    if (text == "sort") mode = BenchmarkMode::Sort;
+    else if (text == "segmented") mode = BenchmarkMode::Segmented;
+    else if (text == "external") mode = BenchmarkMode::External;
+    else if (text == "mmap") mode = BenchmarkMode::Mapped;
+    else if (text == "select") mode = BenchmarkMode::Select;
+    else if (text == "distributed") mode = BenchmarkMode::Distributed;
+    else if (text == "strings") mode = BenchmarkMode::Strings;
+    else return false;
+    return true;
+}
+
+bool parseIsolationMode(const std::string &text, IsolationMode &mode) {
+    if (text == "none") mode = IsolationMode::None;
+    else if (text == "algorithm") mode = IsolationMode::Algorithm;
+    else if (text == "trial") mode = IsolationMode::Trial;
+    else return false;
+    return true;
+}
+
+bool parseOutputFormat(const std::string &text, OutputFormat &format) {
+    if (text == "csv") format = OutputFormat::CSV;
+    else if (text == "json") format = OutputFormat::JSON;
+    else if (text == "none") format = OutputFormat::None;
+    else return false;
+    return true;
+}
+
+// Preset "large": one input past both 2^31 and 2^32 keys (16 GiB), once per
+// algorithm whose index arithmetic depends on the array size
+constexpr size_t LARGE_PRESET_SIZE = (size_t(1) << 32) + (size_t(1) << 20);
+constexpr const char *LARGE_PRESET_ALGORITHMS[] = {
+    "merge-single", "merge-threads", "merge-pool", "quick", "heap", "stl",
+    "natural-merge-pool", "merge-inplace-pool", "radix-lsd-pool"
+};
+
+// Set the options of a named preset. Its algorithms only apply when no -a is
+// given; its other settings are overridden by the options that follow it.
+bool applyPreset(const std::string &name, BenchmarkConfig &config, std::vector<std::string> &algorithms) {
+    if (name != "large") return false;
+    config.array_size = LARGE_PRESET_SIZE;
+    config.iterations = 1;
+    config.distribution = Distribution::Random;
+    algorithms.assign(std::begin(LARGE_PRESET_ALGORITHMS), std::end(LARGE_PRESET_ALGORITHMS));
+    return true;
+}
+
+// Options that take a value: {short name, long name}
+struct ValueOption {
+    const char *short_name;
+    const char *long_name;
+};
+
+constexpr ValueOption VALUE_OPTIONS[] = {
+    {"-n", "--size"},
+    {nullptr, "--sizes"},
+    {"-i", "--iterations"},
+    {"-t", "--threads"},
+    {"-p", "--pool-size"},
+    {"-s", "--seed"},
+    {"-d", "--distributions"},
+    {"-a", "--algorithms"},
+    {"-o", "--output"},
+    {"-f", "--format"},
+    {nullptr, "--save-baseline"},
+    {nullptr, "--compare-baseline"},
+    {nullptr, "--regression-threshold"},
+    {nullptr, "--significance"},
+    {nullptr, "--batch-threshold"},
+    {nullptr, "--batch-elements"},
+    {"-m", "--mode"},
+    {nullptr, "--segment-min"},
+    {nullptr, "--segment-max"},
+    {"-k", "--select-k"},
+    {nullptr, "--workers"},
+    {nullptr, "--isolate"},
+    {nullptr, "--cpus"},
+    {nullptr, "--input"},
+    {nullptr, "--sorted-output"},
+    {nullptr, "--memory-cap"},
+    {nullptr, "--preset"},
+    {nullptr, "--temp-dir"},
+    {nullptr, "--key-bits"},
+};
+
+bool takesValue(const std::string &arg) {
+    for (const auto &option: VALUE_OPTIONS) {
+        if ((option.short_name && arg == option.short_name) || arg == option.long_name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+// ============================================
+// Command line parsing
+// ============================================
+
+bool matchesPattern(const std::string &text, const std::string &pattern) {
+    size_t t = 0, p = 0;
+    size_t star = std::string::npos, resume = 0;
+
+    while (t < text.size()) {
+        if (p < pattern.size() && (pattern[p] == '?' ||
+                                   std::tolower(static_cast<unsigned char>(pattern[p])) ==
+                                   std::tolower(static_cast<unsigned char>(text[t])))) {
+            t++;
+            p++;
+        } else if (p < pattern.size() && pattern[p] == '*') {
+            star = p++;
+            resume = t;
+        } else if (star != std::string::npos) {
+            p = star + 1;
+            t = ++resume;
+        } else {
+            return false;
+        }
+    }
+
+    while (p < pattern.size() && pattern[p] == '*') {
+        p++;
+    }
+    return p == pattern.size();
+}
+
+void printUsage(const char *program) {
+    std::cout << "Usage: " << program << " [options]\n"
+            << "\n"
+            << "Benchmark configuration:\n"
+            << "  -n, --size N                 Array size (K/M/G suffixes allowed)\n"
+            << "      --sizes LIST             Sizes or sweeps, e.g. 1K,10K or 1K:1M:x10 or 1K:5K:+1K\n"
+            << "  -i, --iterations N           Iterations per algorithm\n"
+            << "  -t, --threads N              Thread count for the recursive multi-threaded sort\n"
+            << "  -p, --pool-size N            ThreadPool size\n"
+            << "  -s, --seed N                 Random seed\n"
+            << "  -d, --distributions LIST     random,sorted,reversed,nearly-sorted,few-unique,\n"
+            << "                               organ-pipe,sorted-append,common-prefix\n"
+            << "  -a, --algorithms LIST        Algorithm ids or names; globs allowed (e.g. 'merge-*,stl')\n"
+            << "  -l, --list                   List the available algorithms and exit\n"
+            << "  -m, --mode MODE              sort (whole arrays), segmented (many small segments)\n"
+            << "                               external (file to file, bounded memory) or mmap\n"
+            << "                               (in-place sort of a mapped file vs read-sort-write)\n"
+            << "                               or select (top-k / nth element vs a full sort)\n"
+            << "                               or distributed (sample sort over worker processes)\n"
+            << "                               or strings (string sorts; -n counts strings)\n"
+            << "      --segment-min N          Segmented mode: shortest segment (default 16)\n"
+            << "      --segment-max N          Segmented mode: longest segment (default 500)\n"
+            << "  -k, --select-k N             Select mode: k smallest elements / nth rank (default 100)\n"
+            << "      --workers N              Distributed mode: worker processes, 1-256 (default 4); they\n"
+            << "                               split the --pool-size threads between them\n"
+            << "  -q, --quiet                  Only print the summary, not every iteration\n"
+            << "      --batch-threshold N      Sort inputs smaller than N in timed batches (default 16384)\n"
+            << "      --batch-elements N       Total elements per batched timed region (default 262144)\n"
+            << "      --reuse-scratch          Keep each algorithm's scratch memory across iterations\n"
+            << "      --preset NAME            large: 2^32 + 2^20 random keys, one iteration of the\n"
+            << "                               merge, quick, heap, stl, natural-merge-pool,\n"
+            << "                               merge-inplace-pool and radix-lsd-pool sorts (~64 GiB RAM)\n"
+            << "\n"
+            << "File sorts (--mode external, --mode mmap):\n"
+            << "      --input FILE             Binary keys to sort (default: generate --size keys)\n"
+            << "      --sorted-output FILE     Where to write the sorted keys (default: next to the input)\n"
+            << "      --memory-cap BYTES       Memory budget, K/M/G = KiB/MiB/GiB (default 256M)\n"
+            << "      --temp-dir DIR           Directory for spilled runs and work files (default: system temp)\n"
+            << "      --key-bits N             mmap mode: 32 or 64-bit keys (default 32)\n"
+            << "\n"
+            << "Isolation:\n"
+            << "      --isolate MODE           none, algorithm (one process per algorithm) or trial\n"
+            << "      --cpus LIST              Pin isolated runs to these CPUs, e.g. 0-3,6\n"
+            << "      --shuffle                Randomise the algorithm order (per trial with --isolate trial)\n"
+            << "\n"
+            << "Output:\n"
+            << "  -o, --output FILE            Output file for the per-iteration results\n"
+            << "  -f, --format FORMAT          csv, json or none\n"
+            << "\n"
+            << "Regression detection:\n"
+            << "      --save-baseline FILE     Save this run as a JSON baseline\n"
+            << "      --compare-baseline FILE  Compare against a baseline; exit 1 on a regression,\n"
+            << "                               2 if the baseline cannot be read (or saved)\n"
+            << "      --regression-threshold X Relative median slowdown that counts (default 0.05)\n"
+            << "      --significance X         p-value cutoff (default 0.05)\n"
+            << "\n"
+            << "Environment:\n"
+            << "  SORT_AUTO_PROFILE            Machine profile of -a auto, calibrated on first use\n"
+            << "                               (default ~/.cache/sort-bench/sort_profile.txt)\n"
+            << "\n"
+            << "  -h, --help                   Show this message\n";
+}
+
+bool parseCommandLine(int argc, char **argv, CommandLineOptions &options) {
+    BenchmarkConfig &config = options.config;
+    std::vector<std::string> preset_algorithms;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        std::string value;
+        bool has_inline_value = false;
+
+        // Support both "--opt value" and "--opt=value"
+        size_t equals = arg.find('=');
+        if (arg.rfind("--", 0) == 0 && equals != std::string::npos) {
+            value = arg.substr(equals + 1);
+            arg = arg.substr(0, equals);
+            has_inline_value = true;
+        }
+
+        auto is = [&arg](const char *short_name, const char *long_name) {
+            return (short_name && arg == short_name) || arg == long_name;
+        };
+
+        // Flags without a value
+        if (is("-h", "--help")) {
+            options.show_help = true;
+            continue;
+        }
+        if (is("-l", "--list")) {
+            options.list_algorithms = true;
+            continue;
+        }
+        if (is("-q", "--quiet")) {
+            config.verbose = false;
+            continue;
+        }
+        if (is(nullptr, "--shuffle")) {
+            config.shuffle_order = true;
+            continue;
+        }
+        if (is(nullptr, "--reuse-scratch")) {
+            config.reuse_scratch = true;
+            continue;
+        }
+
+        if (!takesValue(arg)) {
+            std::cerr << "Error: Unknown option " << arg << " (see --help)" << std::endl;
+            return false;
+        }
+
+        // argv strings outlive the config, so const char * fields can point straight into them
+        const char *raw_value = nullptr;
+        if (has_inline_value) {
+            raw_value = argv[i] + (std::string(argv[i]).find('=') + 1);
+        } else if (i + 1 < argc) {
+            raw_value = argv[++i];
+            value = raw_value;
+        } else {
+            std::cerr << "Error: Missing value for " << arg << std::endl;
+            return false;
+        }
+
+        bool ok = true;
+        if (is("-n", "--size")) {
+            ok = parseCount(value, config.array_size);
+        } else if (is(nullptr, "--sizes")) {
+            ok = parseSizes(value, options.sizes);
+        } else if (is("-i", "--iterations")) {
+            ok = parseInt(value, config.iterations) && config.iterations > 0;
+        } else if (is("-t", "--threads")) {
+            ok = parseInt(value, config.thread_count) && config.thread_count > 0;
+        } else if (is("-p", "--pool-size")) {
+            ok = parseInt(value, config.threadpool_size) && config.threadpool_size > 0;
+        } else if (is("-s", "--seed")) {
+            size_t seed = 0;
+            ok = parseCount(value, seed);
+            config.random_seed = static_cast<unsigned int>(seed);
+        } else if (is("-d", "--distributions")) {
+            for (const auto &name: splitList(value)) {
+                Distribution distribution;
+                if (!parseDistribution(name, distribution)) {
+                    ok = false;
+                    break;
+                }
+                options.distributions.push_back(distribution);
+            }
+        } else if (is("-a", "--algorithms")) {
+            for (const auto &pattern: splitList(value)) {
+                options.algorithm_patterns.push_back(pattern);
+            }
+            ok = !options.algorithm_patterns.empty();
+        } else if (is("-o", "--output")) {
+            config.output_file = raw_value;
+        } else if (is("-f", "--format")) {
+            ok = parseOutputFormat(value, config.output_format);
+        } else if (is(nullptr, "--save-baseline")) {
+            config.baseline_save_file = raw_value;
+        } else if (is(nullptr, "--compare-baseline")) {
+            config.baseline_compare_file = raw_value;
+        } else if (is(nullptr, "--regression-threshold")) {
+            ok = parseDouble(value, config.regression_threshold) && config.regression_threshold >= 0.0;
+        } else if (is(nullptr, "--batch-threshold")) {
+            ok = parseCount(value, config.batch_threshold);
+        } else if (is(nullptr, "--batch-elements")) {
+            ok = parseCount(value, config.batch_elements);
+        } else if (is("-m", "--mode")) {
+            ok = parseBenchmarkMode(value, config.mode);
+        } else if (is(nullptr, "--segment-min")) {
+            ok = parseCount(value, config.segment_min) && config.segment_min > 0;
+        } else if (is("-k", "--select-k")) {
+            ok = parseCount(value, config.select_k);
+        } else if (is(nullptr, "--workers")) {
+            ok = parseCount(value, config.distributed_workers) &&
+                 config.distributed_workers >= 1 && config.distributed_workers <= 256;
+        } else if (is(nullptr, "--segment-max")) {
+            ok = parseCount(value, config.segment_max) && config.segment_max > 0;
+        } else if (is(nullptr, "--isolate")) {
+            ok = parseIsolationMode(value, config.isolation);
+        } else if (is(nullptr, "--cpus")) {
+            std::vector<int> cpus;
+            ok = parseCpuSet(value, cpus);
+            config.cpu_set = raw_value;
+        } else if (is(nullptr, "--input")) {
+            config.external_input = raw_value;
+        } else if (is(nullptr, "--sorted-output")) {
+            config.external_output = raw_value;
+        } else if (is(nullptr, "--memory-cap")) {
+            ok = parseBytes(value, config.memory_cap) && config.memory_cap >= sizeof(int) * 2;
+        } else if (is(nullptr, "--temp-dir")) {
+            config.temp_dir = raw_value;
+        } else if (is(nullptr, "--key-bits")) {
+            int bits = 0;
+            ok = parseInt(value, bits) && (bits == 32 || bits == 64);
+            config.key_bits = static_cast<unsigned>(bits);
+        } else if (is(nullptr, "--significance")) {
+            ok = parseDouble(value, config.significance_level) &&
+                 config.significance_level > 0.0 && config.significance_level < 1.0;
+        } else if (is(nullptr, "--preset")) {
+            ok = applyPreset(value, config, preset_algorithms);
+        }
+
+        if (!ok) {
+            std::cerr << "Error: Invalid value '" << value << "' for " << arg << std::endl;
+            return false;
+        }
+    }
+
+    if (options.algorithm_patterns.empty()) {
+        options.algorithm_patterns = preset_algorithms;
+    }
+
+    if (config.segment_max < config.segment_min) {
+        std::cerr << "Error: --segment-max must not be smaller than --segment-min" << std::endl;
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,26 @@
+#ifndef CLI_H
+#define CLI_H
+
+#include <string>
+#include <vector>
+#include "config.h"
+
+// Everything the benchmark binary can be told on its command line
+struct CommandLineOptions {
+    BenchmarkConfig config;
+    std::vector<std::string> algorithm_patterns;   // empty = every algorithm
+    std::vector<size_t> sizes;                     // empty = config.array_size
+    std::vector<Distribution> distributions;       // empty = config.distribution
+    bool list_algorithms = false;
+    bool show_help = false;
+};
+
+// Parse argv into options; prints a message and returns false on invalid input
+bool parseCommandLine(int argc, char **argv, CommandLineOptions &options);
+
+void printUsage(const char *program);
+
+// Case-insensitive glob match supporting '*' and '?'
+bool matchesPattern(const std::string &text, const std::string &pattern);
+
+#endif // CLI_H
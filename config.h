@@ -3,6 +3,43 @@
 
 #include <cstddef>
 
+// Input patterns the benchmark can generate
+enum class Distribution {
+    Random,
+    Sorted,
+    Reversed,
+    NearlySorted,
+    FewUnique,
+    OrganPipe,
+    SortedAppend,   // sorted 90%, then 10% random keys appended
+    CommonPrefix    // random keys sharing a long prefix: the top 16 bits, or a URL for strings
+};
+
+// Formats the benchmark can export its per-iteration results in
+enum class OutputFormat {
+    CSV,
+    JSON,
+    None
+};
+
+// What the benchmark measures
+enum class BenchmarkMode {
+    Sort,        // one array per sort call
+    Segmented,   // many small independent segments of one flat buffer per call
+    External,    // file-to-file sort of data that need not fit in memory
+    Mapped,      // in-place sort of a memory-mapped key file vs read-sort-write
+    Select,      // top-k, partial sort and nth element against a full sort
+    Distributed, // sample sort across worker processes over shared memory
+    Strings      // string sorts over an arena of generated strings
+};
+
+// How benchmark iterations are isolated from each other
+enum class IsolationMode {
+    None,        // everything runs in this process
+    Algorithm,   // one forked child per algorithm and input
+    Trial        // one forked child per iteration
+};
+
 struct BenchmarkConfig {
     size_t array_size = 100000;
     int iterations = 100;
@@ -10,6 +47,40 @@ struct BenchmarkConfig {
     int threadpool_size = 8;
     unsigned int random_seed = 42;
     const char *output_file = "benchmark_results.csv";
+    OutputFormat output_format = OutputFormat::CSV;
+    Distribution distribution = Distribution::Random;
+    BenchmarkMode mode = BenchmarkMode::Sort;
+    size_t segment_min = 16;              // segmented mode: segment lengths are uniform in [min, max]
+    size_t segment_max = 500;
+    bool verbose = true;                  // print every iteration, not just the summary
+    size_t select_k = 100;                // select mode: k smallest elements / nth element rank
+    bool reuse_scratch = false;           // give every algorithm a SortContext kept across iterations
+    size_t distributed_workers = 4;       // distributed mode: worker processes, sharing threadpool_size threads
+
+    // External mode: sort external_input (generated from array_size/distribution when null)
+    // into external_output, holding at most memory_cap bytes of keys in memory.
+    // Mapped mode sorts copies of external_input of key_bits-wide keys.
+    const char *external_input = nullptr;
+    const char *external_output = nullptr;
+    size_t memory_cap = size_t(256) << 20;
+    const char *temp_dir = nullptr;       // where sorted runs are spilled; null = system temp
+    unsigned key_bits = 32;               // mapped mode: 32 or 64
+
+    // Inputs smaller than batch_threshold are sorted in batches of about
+    // batch_elements total elements per timed region, reporting the per-sort average
+    size_t batch_threshold = 16384;
+    size_t batch_elements = 1 << 18;
+
+    // Process isolation
+    IsolationMode isolation = IsolationMode::None;
+    const char *cpu_set = nullptr;        // CPUs to pin children to, e.g. "0-3"; null = inherit
+    bool shuffle_order = false;           // randomise the algorithm order per input (and per trial)
+
+    // Regression detection (disabled when the file names are null)
+    const char *baseline_save_file = nullptr;
+    const char *baseline_compare_file = nullptr;
+    double regression_threshold = 0.05;   // relative slowdown of the median that counts as a regression
+    double significance_level = 0.05;     // p-value cutoff for the Mann-Whitney U test
 };
 
 #endif // CONFIG_H
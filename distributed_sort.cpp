@@ -0,0 +1,432 @@
+#include "distributed_sort.h"
+#include "sorting_algorithms.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <span>
+#include <string>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SORT_BENCH_HAS_SHM 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Destination workers are stored as one byte per key during the partition
+constexpr size_t MAX_WORKERS = 256;
+
+// Input slice [first, second) owned by worker `rank`
+std::pair<size_t, size_t> sliceOf(size_t n, size_t rank, size_t workers) {
+    return {n * rank / workers, n * (rank + 1) / workers};
+}
+
+#ifdef SORT_BENCH_HAS_SHM
+
+// A worker that died must fail the send, not kill the sender with SIGPIPE
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0;
+#endif
+
+// Messages between the coordinator and a worker, in protocol order
+enum class Message : uint32_t {
+    Attached,     // worker: segment mapped and pool running
+    Start,        // coordinator: take samples
+    Samples,      // worker: sampled keys
+    Splitters,    // coordinator: workers - 1 ascending splitters
+    Counts,       // worker: number of its keys bound for each worker
+    Offsets,      // coordinator: output position for each destination, then the worker's own partition
+    Exchanged,    // worker: scatter finished
+    Sort,         // coordinator: every partition is complete
+    Sorted        // worker: partition sorted
+};
+
+struct MessageHeader {
+    Message type;
+    uint32_t reserved;
+    uint64_t bytes;     // payload that follows
+};
+
+bool sendAll(int fd, const void *data, size_t size) {
+    const char *ptr = static_cast<const char *>(data);
+    while (size > 0) {
+        ssize_t sent = send(fd, ptr, size, SEND_FLAGS);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        ptr += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+// False on error or when the peer hung up
+bool receiveAll(int fd, void *data, size_t size) {
+    char *ptr = static_cast<char *>(data);
+    while (size > 0) {
+        ssize_t received = recv(fd, ptr, size, 0);
+        if (received < 0 && errno == EINTR) continue;
+        if (received <= 0) return false;
+        ptr += received;
+        size -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+template<class T>
+bool sendMessage(int fd, Message type, std::span<const T> payload) {
+    MessageHeader header{type, 0, payload.size_bytes()};
+    return sendAll(fd, &header, sizeof(header)) &&
+           (payload.empty() || sendAll(fd, payload.data(), payload.size_bytes()));
+}
+
+bool sendMessage(int fd, Message type) {
+    return sendMessage<std::byte>(fd, type, {});
+}
+
+// Receive the next message, which must be of the expected type and carry whole T's
+template<class T>
+bool receiveMessage(int fd, Message expected, std::vector<T> &payload) {
+    MessageHeader header{};
+    if (!receiveAll(fd, &header, sizeof(header)) || header.type != expected || header.bytes % sizeof(T) != 0) {
+        return false;
+    }
+    payload.resize(header.bytes / sizeof(T));
+    return payload.empty() || receiveAll(fd, payload.data(), header.bytes);
+}
+
+bool receiveMessage(int fd, Message expected) {
+    std::vector<std::byte> payload;
+    return receiveMessage(fd, expected, payload) && payload.empty();
+}
+
+// Everything a worker process needs besides its socket
+struct WorkerSetup {
+    const char *segment_name;
+    size_t elements;
+    size_t rank;
+    size_t workers;
+    const DistributedSortOptions *options;
+};
+
+// The worker side of the protocol over its local slice of `input`
+bool runWorkerPhases(const WorkerSetup &setup, int fd, const int *input, int *output, ThreadPool &pool) {
+    const size_t workers = setup.workers;
+    auto [first, last] = sliceOf(setup.elements, setup.rank, workers);
+    std::span<const int> local(input + first, last - first);
+
+    if (!sendMessage(fd, Message::Attached) || !receiveMessage(fd, Message::Start)) return false;
+
+    // Sampling: keys at random positions of the local slice
+    std::vector<int> samples;
+    if (!local.empty()) {
+        std::mt19937_64 gen(setup.options->seed + setup.rank);
+        std::uniform_int_distribution<size_t> position(0, local.size() - 1);
+        samples.resize(setup.options->samples_per_worker);
+        for (int &sample: samples) {
+            sample = local[position(gen)];
+        }
+    }
+    std::vector<int> splitters;
+    if (!sendMessage<int>(fd, Message::Samples, samples) ||
+        !receiveMessage(fd, Message::Splitters, splitters) || splitters.size() != workers - 1) {
+        return false;
+    }
+
+    // Exchange: destination of every local key (keys equal to a splitter go
+    // right), then the scatter to the offsets the coordinator hands out
+    std::vector<uint8_t> destination(local.size());
+    parallelFor(pool, local.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            destination[i] = static_cast<uint8_t>(
+                std::upper_bound(splitters.begin(), splitters.end(), local[i]) - splitters.begin());
+        }
+    });
+    std::vector<uint64_t> counts(workers, 0);
+    for (uint8_t target: destination) {
+        counts[target]++;
+    }
+    std::vector<uint64_t> offsets;
+    if (!sendMessage<uint64_t>(fd, Message::Counts, counts) ||
+        !receiveMessage(fd, Message::Offsets, offsets) || offsets.size() != workers + 2) {
+        return false;
+    }
+    for (size_t i = 0; i < local.size(); i++) {
+        output[offsets[destination[i]]++] = local[i];
+    }
+    if (!sendMessage(fd, Message::Exchanged) || !receiveMessage(fd, Message::Sort)) return false;
+
+    // Local sort of the partition every worker has now written into
+    size_t begin = offsets[workers];
+    size_t end = offsets[workers + 1];
+    mergeSortThreadPool(std::span<int>(output + begin, end - begin), pool);
+    return sendMessage(fd, Message::Sorted);
+}
+
+// Body of a worker process: attach to the segment by name, as a process on
+// another node would, and run the protocol on its own pool
+bool runWorker(const WorkerSetup &setup, int fd) {
+    size_t bytes = 2 * setup.elements * sizeof(int);
+    int shm = shm_open(setup.segment_name, O_RDWR, 0);
+    if (shm < 0) return false;
+    void *segment = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, shm, 0);
+    close(shm);
+    if (segment == MAP_FAILED) return false;
+
+    int *input = static_cast<int *>(segment);
+    bool ok;
+    {
+        ThreadPool pool(std::max<size_t>(setup.options->threads_per_worker, 1));
+        ok = runWorkerPhases(setup, fd, input, input + setup.elements, pool);
+    }
+    munmap(segment, bytes);
+    return ok;
+}
+
+// Coordinator-side resources of one run. shutdown() releases whatever was set
+// up; closing the sockets makes every worker still waiting for a message exit.
+struct Cluster {
+    std::string segment_name;
+    bool segment_linked = false;
+    void *segment = MAP_FAILED;
+    size_t segment_bytes = 0;
+    std::vector<int> sockets;    // coordinator end, per worker
+    std::vector<pid_t> pids;
+
+    ~Cluster() { shutdown(); }
+
+    void shutdown() {
+        for (int fd: sockets) {
+            close(fd);
+        }
+        sockets.clear();
+        for (pid_t pid: pids) {
+            int status = 0;
+            while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+            }
+        }
+        pids.clear();
+        if (segment != MAP_FAILED) {
+            munmap(segment, segment_bytes);
+            segment = MAP_FAILED;
+        }
+        unlink();
+    }
+
+    void unlink() {
+        if (segment_linked) {
+            shm_unlink(segment_name.c_str());
+            segment_linked = false;
+        }
+    }
+};
+
+bool workerFailed(size_t rank) {
+    std::cerr << "Error: Distributed sort worker " << rank << " failed or hung up" << std::endl;
+    return false;
+}
+
+#endif
+
+} // namespace
+
+double DistributedSortStats::imbalance() const {
+    if (elements == 0 || partition_offsets.size() < 2) return 1.0;
+    size_t largest = 0;
+    for (size_t w = 0; w + 1 < partition_offsets.size(); w++) {
+        largest = std::max(largest, partition_offsets[w + 1] - partition_offsets[w]);
+    }
+    return static_cast<double>(largest) * static_cast<double>(workers) / static_cast<double>(elements);
+}
+
+bool distributedSortSupported() {
+#ifdef SORT_BENCH_HAS_SHM
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool distributedSort(std::vector<int> &data, const DistributedSortOptions &options, DistributedSortStats &stats) {
+    stats = DistributedSortStats();
+    const size_t n = data.size();
+    const size_t workers = std::clamp<size_t>(options.workers, 1, MAX_WORKERS);
+    stats.elements = n;
+    stats.workers = workers;
+    stats.partition_offsets.assign(workers + 1, 0);
+    if (n == 0) return true;
+
+#ifdef SORT_BENCH_HAS_SHM
+    // Setup: the segment holds the input slices, then the output partitions
+    auto phase_start = Clock::now();
+    static std::atomic<unsigned> run_counter{0};
+    Cluster cluster;
+    cluster.segment_name = "/sort-bench-" + std::to_string(getpid()) + "-" + std::to_string(run_counter++);
+    cluster.segment_bytes = 2 * n * sizeof(int);
+
+    int shm = shm_open(cluster.segment_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (shm < 0) {
+        std::cerr << "Error: Could not create shared memory segment " << cluster.segment_name << ": "
+                << std::strerror(errno) << std::endl;
+        return false;
+    }
+    cluster.segment_linked = true;
+    if (ftruncate(shm, static_cast<off_t>(cluster.segment_bytes)) != 0) {
+        std::cerr << "Error: Could not size shared memory segment to " << cluster.segment_bytes << " bytes: "
+                << std::strerror(errno) << std::endl;
+        close(shm);
+        return false;
+    }
+
+    // Flush so buffered output is not duplicated by the workers
+    std::cout.flush();
+    std::cerr.flush();
+    for (size_t rank = 0; rank < workers; rank++) {
+        int ends[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, ends) != 0) {
+            std::cerr << "Error: socketpair() failed: " << std::strerror(errno) << std::endl;
+            close(shm);
+            return false;
+        }
+        pid_t pid = fork();
+        if (pid < 0) {
+            std::cerr << "Error: fork() failed: " << std::strerror(errno) << std::endl;
+            close(ends[0]);
+            close(ends[1]);
+            close(shm);
+            return false;
+        }
+        if (pid == 0) {
+            // Keep only this worker's end open, so each worker sees the coordinator hang up
+            close(ends[0]);
+            close(shm);
+            for (int fd: cluster.sockets) {
+                close(fd);
+            }
+            WorkerSetup setup{cluster.segment_name.c_str(), n, rank, workers, &options};
+            bool ok = runWorker(setup, ends[1]);
+            _exit(ok ? 0 : 1);
+        }
+        close(ends[1]);
+        cluster.sockets.push_back(ends[0]);
+        cluster.pids.push_back(pid);
+    }
+
+    cluster.segment = mmap(nullptr, cluster.segment_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, shm, 0);
+    close(shm);
+    if (cluster.segment == MAP_FAILED) {
+        std::cerr << "Error: Could not map shared memory segment: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    int *input = static_cast<int *>(cluster.segment);
+    int *output = input + n;
+    std::copy(data.begin(), data.end(), input);
+
+    for (size_t rank = 0; rank < workers; rank++) {
+        if (!receiveMessage(cluster.sockets[rank], Message::Attached)) return workerFailed(rank);
+    }
+    // Every worker has mapped the segment, so its name can go
+    cluster.unlink();
+    stats.setup_seconds = secondsSince(phase_start);
+
+    // Sampling: gather every worker's samples and broadcast evenly spaced splitters
+    phase_start = Clock::now();
+    for (size_t rank = 0; rank < workers; rank++) {
+        if (!sendMessage(cluster.sockets[rank], Message::Start)) return workerFailed(rank);
+    }
+    std::vector<int> samples;
+    std::vector<int> received;
+    for (size_t rank = 0; rank < workers; rank++) {
+        if (!receiveMessage(cluster.sockets[rank], Message::Samples, received)) return workerFailed(rank);
+        samples.insert(samples.end(), received.begin(), received.end());
+    }
+    std::sort(samples.begin(), samples.end());
+    std::vector<int> splitters(workers - 1);
+    for (size_t i = 1; i < workers; i++) {
+        splitters[i - 1] = samples[i * samples.size() / workers];
+    }
+    for (size_t rank = 0; rank < workers; rank++) {
+        if (!sendMessage<int>(cluster.sockets[rank], Message::Splitters, splitters)) return workerFailed(rank);
+    }
+    stats.sampling_seconds = secondsSince(phase_start);
+
+    // Exchange: partitions are laid out by destination worker, and within one
+    // partition by source worker, so every source writes disjoint ranges
+    phase_start = Clock::now();
+    std::vector<std::vector<uint64_t>> counts(workers);
+    for (size_t rank = 0; rank < workers; rank++) {
+        if (!receiveMessage(cluster.sockets[rank], Message::Counts, counts[rank]) ||
+            counts[rank].size() != workers) {
+            return workerFailed(rank);
+        }
+    }
+    std::vector<uint64_t> partition(workers + 1, 0);
+    for (size_t target = 0; target < workers; target++) {
+        partition[target + 1] = partition[target];
+        for (size_t source = 0; source < workers; source++) {
+            partition[target + 1] += counts[source][target];
+        }
+    }
+    if (partition[workers] != n) {
+        std::cerr << "Error: Distributed sort workers reported " << partition[workers] << " keys, expected " << n
+                << std::endl;
+        return false;
+    }
+    std::vector<uint64_t> next(partition.begin(), partition.end() - 1);
+    for (size_t source = 0; source < workers; source++) {
+        std::vector<uint64_t> offsets(workers + 2);
+        for (size_t target = 0; target < workers; target++) {
+            offsets[target] = next[target];
+            next[target] += counts[source][target];
+        }
+        offsets[workers] = partition[source];
+        offsets[workers + 1] = partition[source + 1];
+        if (!sendMessage<uint64_t>(cluster.sockets[source], Message::Offsets, offsets)) return workerFailed(source);
+    }
+    for (size_t rank = 0; rank < workers; rank++) {
+        if (!receiveMessage(cluster.sockets[rank], Message::Exchanged)) return workerFailed(rank);
+    }
+    stats.exchange_seconds = secondsSince(phase_start);
+
+    // Local sort, started only once every partition is complete
+    phase_start = Clock::now();
+    for (size_t rank = 0; rank < workers; rank++) {
+        if (!sendMessage(cluster.sockets[rank], Message::Sort)) return workerFailed(rank);
+    }
+    for (size_t rank = 0; rank < workers; rank++) {
+        if (!receiveMessage(cluster.sockets[rank], Message::Sorted)) return workerFailed(rank);
+    }
+    stats.local_sort_seconds = secondsSince(phase_start);
+
+    phase_start = Clock::now();
+    std::copy(output, output + n, data.begin());
+    stats.partition_offsets.assign(partition.begin(), partition.end());
+    cluster.shutdown();
+    stats.collect_seconds = secondsSince(phase_start);
+    return true;
+#else
+    (void) options;
+    std::cerr << "Error: Distributed sorting needs Unix sockets and POSIX shared memory" << std::endl;
+    return false;
+#endif
+}
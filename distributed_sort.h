@@ -0,0 +1,53 @@
+#ifndef DISTRIBUTED_SORT_H
+#define DISTRIBUTED_SORT_H
+
+#include <cstddef>
+#include <vector>
+
+// Shape of a distributedSort run
+struct DistributedSortOptions {
+    size_t workers = 4;                 // worker processes, at most 256
+    size_t threads_per_worker = 2;      // ThreadPool size inside each worker
+    size_t samples_per_worker = 256;    // keys each worker contributes to splitter selection
+    unsigned int seed = 42;             // sample positions
+};
+
+// Where the time went, measured by the coordinator between the barriers that
+// separate the phases
+struct DistributedSortStats {
+    size_t elements = 0;
+    size_t workers = 0;
+    double setup_seconds = 0.0;         // shared memory, copy-in, starting and attaching the workers
+    double sampling_seconds = 0.0;      // local samples, gathering them, broadcasting splitters
+    double exchange_seconds = 0.0;      // local partition, bucket counts, all-to-all scatter
+    double local_sort_seconds = 0.0;    // every worker sorting the partition it received
+    double collect_seconds = 0.0;       // copy-out and shutting the workers down
+    std::vector<size_t> partition_offsets;    // worker w owns [offsets[w], offsets[w + 1]) of the output
+
+    double totalSeconds() const {
+        return setup_seconds + sampling_seconds + exchange_seconds + local_sort_seconds + collect_seconds;
+    }
+
+    // Largest partition over the mean partition size (1.0 = perfectly balanced)
+    double imbalance() const;
+};
+
+// True when this build can run worker processes over Unix sockets and POSIX
+// shared memory
+bool distributedSortSupported();
+
+// Sample sort over worker processes, with this process as the coordinator.
+// The keys are placed in a POSIX shared memory segment, and each worker owns
+// one contiguous slice of it as its local data. Workers send key samples over
+// their Unix socket. The coordinator picks splitters from the samples and
+// broadcasts them. Each worker then partitions its slice by the splitters,
+// and the coordinator turns the bucket counts of all workers into write
+// offsets. Workers scatter every bucket straight into the partition of the
+// worker that owns it (the all-to-all exchange). Finally each worker sorts
+// its partition with mergeSortThreadPool on its own pool. On return `data` is
+// globally sorted, and stats.partition_offsets tells which worker produced
+// which part. Returns false (with a message on stderr) if the segment, a
+// socket or a worker fails.
+bool distributedSort(std::vector<int> &data, const DistributedSortOptions &options, DistributedSortStats &stats);
+
+#endif // DISTRIBUTED_SORT_H
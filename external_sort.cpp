@@ -0,0 +1,392 @@
+#include "external_sort.h"
+#include "sorting_algorithms.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <queue>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#define SORT_BENCH_HAS_RLIMIT 1
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+struct FileCloser {
+    void operator()(std::FILE *file) const {
+        if (file) std::fclose(file);
+    }
+};
+
+using FilePtr = std::unique_ptr<std::FILE, FileCloser>;
+
+FilePtr openFile(const std::string &path, const char *mode) {
+    FilePtr file(std::fopen(path.c_str(), mode));
+    if (!file) {
+        std::cerr << "Error: Could not open " << path << std::endl;
+    }
+    return file;
+}
+
+// Flush and close a file that was written, so errors in stdio's buffered
+// tail (e.g. a full disk) are reported instead of lost in the deleter
+bool closeWritten(FilePtr &file, const std::string &path) {
+    bool ok = std::fflush(file.get()) == 0;
+    ok = std::fclose(file.release()) == 0 && ok;
+    if (!ok) {
+        std::cerr << "Error: Failed writing " << path << std::endl;
+    }
+    return ok;
+}
+
+// Files the process may still open, leaving headroom for stdio, the output
+// file and whatever else is open (unlimited where that cannot be queried)
+size_t openFileBudget() {
+    constexpr size_t RESERVED_FILES = 16;
+#ifdef SORT_BENCH_HAS_RLIMIT
+    rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY) {
+        size_t files = static_cast<size_t>(limit.rlim_cur);
+        return files > RESERVED_FILES ? files - RESERVED_FILES : 0;
+    }
+#endif
+    return SIZE_MAX;
+}
+
+// Removes spilled run files however the sort exits
+struct RunFiles {
+    std::vector<std::string> paths;
+
+    ~RunFiles() {
+        std::error_code ignored;
+        for (const auto &path: paths) {
+            std::filesystem::remove(path, ignored);
+        }
+    }
+};
+
+// Streams a sorted run block by block. While the merge consumes the current
+// block, the pool is already reading the next one into the spare buffer. A
+// read error ends the run early and sets failed().
+class RunReader {
+public:
+    RunReader(FilePtr file, size_t block_elements, ThreadPool &pool)
+        : file_(std::move(file)), pool_(pool), current_(block_elements), next_(block_elements) {
+        prefetch();
+        advance();
+    }
+
+    // The prefetch task reads into next_ from file_, so it must finish first
+    ~RunReader() {
+        if (pending_.valid()) {
+            pending_.wait();
+        }
+    }
+
+    RunReader(const RunReader &) = delete;
+
+    RunReader &operator=(const RunReader &) = delete;
+
+    bool exhausted() const { return pos_ == size_; }
+
+    bool failed() const { return failed_; }
+
+    int front() const { return current_[pos_]; }
+
+    void pop() {
+        if (++pos_ == size_) {
+            advance();
+        }
+    }
+
+private:
+    FilePtr file_;
+    ThreadPool &pool_;
+    std::vector<int> current_;
+    std::vector<int> next_;
+    size_t pos_ = 0;
+    size_t size_ = 0;
+    bool failed_ = false;
+    std::future<size_t> pending_;
+
+    void prefetch() {
+        std::FILE *file = file_.get();
+        std::vector<int> *buffer = &next_;
+        pending_ = pool_.submit([file, buffer]() {
+            return std::fread(buffer->data(), sizeof(int), buffer->size(), file);
+        });
+    }
+
+    void advance() {
+        size_t loaded = pending_.get();
+        std::swap(current_, next_);
+        pos_ = 0;
+        size_ = loaded;
+        if (loaded == current_.size()) {
+            prefetch();
+        } else {
+            // Short read: end of run (or a read error), nothing left to prefetch
+            failed_ = failed_ || std::ferror(file_.get());
+            pending_ = std::async(std::launch::deferred, []() { return size_t(0); });
+        }
+    }
+};
+
+// Buffers merged output; full blocks are written by the pool while the merge
+// keeps filling the other buffer
+class BlockWriter {
+public:
+    BlockWriter(std::FILE *file, size_t block_elements, ThreadPool &pool)
+        : file_(file), pool_(pool), current_(block_elements), spare_(block_elements) {
+        pending_ = std::async(std::launch::deferred, []() { return true; });
+    }
+
+    // A background write still reads from spare_
+    ~BlockWriter() {
+        if (pending_.valid()) {
+            pending_.wait();
+        }
+    }
+
+    BlockWriter(const BlockWriter &) = delete;
+
+    BlockWriter &operator=(const BlockWriter &) = delete;
+
+    void push(int value) {
+        current_[count_++] = value;
+        if (count_ == current_.size()) {
+            flush();
+        }
+    }
+
+    // Write the partial last block and wait for every outstanding write
+    bool finish() {
+        flush();
+        return pending_.get() && ok_;
+    }
+
+private:
+    std::FILE *file_;
+    ThreadPool &pool_;
+    std::vector<int> current_;
+    std::vector<int> spare_;
+    size_t count_ = 0;
+    bool ok_ = true;
+    std::future<bool> pending_;
+
+    void flush() {
+        ok_ = pending_.get() && ok_;
+        std::swap(current_, spare_);
+
+        std::FILE *file = file_;
+        const int *data = spare_.data();
+        size_t count = count_;
+        pending_ = pool_.submit([file, data, count]() {
+            return std::fwrite(data, sizeof(int), count, file) == count;
+        });
+        count_ = 0;
+    }
+};
+
+bool writeAll(std::FILE *file, const std::vector<int> &data, size_t count, const std::string &path) {
+    if (std::fwrite(data.data(), sizeof(int), count, file) != count) {
+        std::cerr << "Error: Failed writing " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// k-way merge of the sorted run files `inputs` into output_path with
+// double-buffered prefetching readers and a background writer
+bool mergeRunFiles(const std::vector<std::string> &inputs, const std::string &output_path, size_t block_elements,
+                   ThreadPool &pool) {
+    std::vector<std::unique_ptr<RunReader>> readers;
+    readers.reserve(inputs.size());
+    for (const auto &path: inputs) {
+        FilePtr run = openFile(path, "rb");
+        if (!run) return false;
+        readers.push_back(std::make_unique<RunReader>(std::move(run), block_elements, pool));
+    }
+
+    FilePtr output = openFile(output_path, "wb");
+    if (!output) return false;
+    BlockWriter writer(output.get(), block_elements, pool);
+
+    using HeapEntry = std::pair<int, size_t>;
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<>> heap;
+    for (size_t r = 0; r < readers.size(); r++) {
+        if (!readers[r]->exhausted()) {
+            heap.emplace(readers[r]->front(), r);
+        }
+    }
+
+    while (!heap.empty()) {
+        auto [value, r] = heap.top();
+        heap.pop();
+        writer.push(value);
+
+        RunReader &reader = *readers[r];
+        reader.pop();
+        if (!reader.exhausted()) {
+            heap.emplace(reader.front(), r);
+        }
+    }
+
+    if (!writer.finish()) {
+        std::cerr << "Error: Failed writing " << output_path << std::endl;
+        return false;
+    }
+    if (!closeWritten(output, output_path)) {
+        return false;
+    }
+    for (size_t r = 0; r < readers.size(); r++) {
+        if (readers[r]->failed()) {
+            std::cerr << "Error: Failed reading " << inputs[r] << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+double ExternalSortStats::throughputMBps() const {
+    double seconds = totalSeconds();
+    if (seconds <= 0.0) return 0.0;
+    return static_cast<double>(elements) * sizeof(int) / (1024.0 * 1024.0) / seconds;
+}
+
+bool externalSort(const std::string &input_path, const std::string &output_path,
+                  const ExternalSortOptions &options, ThreadPool &pool, ExternalSortStats &stats) {
+    stats = ExternalSortStats();
+
+    std::error_code error;
+    uintmax_t input_bytes = std::filesystem::file_size(input_path, error);
+    if (error) {
+        std::cerr << "Error: Could not stat " << input_path << ": " << error.message() << std::endl;
+        return false;
+    }
+    if (input_bytes % sizeof(int) != 0) {
+        std::cerr << "Error: " << input_path << " is not a whole number of 32-bit keys" << std::endl;
+        return false;
+    }
+    stats.elements = static_cast<size_t>(input_bytes / sizeof(int));
+
+    FilePtr input = openFile(input_path, "rb");
+    if (!input) return false;
+
+    // mergeSortThreadPool needs scratch space about the size of the chunk
+    size_t chunk_elements = std::max<size_t>(1, options.memory_limit_bytes / (2 * sizeof(int)));
+    chunk_elements = std::min(chunk_elements, std::max<size_t>(1, stats.elements));
+
+    std::filesystem::path temp_directory = options.temp_directory.empty()
+                                               ? std::filesystem::temp_directory_path(error)
+                                               : std::filesystem::path(options.temp_directory);
+    if (error) {
+        std::cerr << "Error: No temp directory available: " << error.message() << std::endl;
+        return false;
+    }
+    std::string run_prefix = (temp_directory / ("extsort_" + std::to_string(
+                                                     Clock::now().time_since_epoch().count()) + "_")).string();
+
+    // --- 1. Run formation: read a chunk, sort it in parallel, spill it ---
+    auto run_start = Clock::now();
+    RunFiles runs;
+    bool single_run = stats.elements <= chunk_elements;
+    {
+        std::vector<int> chunk;
+        chunk.reserve(chunk_elements);
+        size_t remaining = stats.elements;
+
+        while (remaining > 0) {
+            size_t count = std::min(chunk_elements, remaining);
+            chunk.resize(count);
+            if (std::fread(chunk.data(), sizeof(int), count, input.get()) != count) {
+                std::cerr << "Error: Short read from " << input_path << std::endl;
+                return false;
+            }
+            remaining -= count;
+
+            mergeSortThreadPool(chunk, pool);
+
+            // A single run is the final output: skip the merge pass entirely
+            std::string path = single_run ? output_path : run_prefix + std::to_string(runs.paths.size()) + ".run";
+            if (!single_run) {
+                runs.paths.push_back(path);
+            }
+            FilePtr run = openFile(path, "wb");
+            if (!run || !writeAll(run.get(), chunk, count, path) || !closeWritten(run, path)) {
+                return false;
+            }
+        }
+
+        if (stats.elements == 0) {
+            FilePtr empty = openFile(output_path, "wb");
+            if (!empty || !closeWritten(empty, output_path)) return false;
+        }
+    }
+    input.reset();
+    stats.runs = single_run ? (stats.elements ? 1 : 0) : runs.paths.size();
+    stats.run_phase_seconds = secondsSince(run_start);
+
+    if (single_run) {
+        return true;
+    }
+
+    // --- 2. k-way merge with double-buffered prefetching readers ---
+    // Each merged run and the output hold two blocks; a wider merge would
+    // overrun the memory limit (or the open file budget), so runs are first
+    // merged in groups of fan_in into intermediate runs
+    auto merge_start = Clock::now();
+    size_t min_block_elements = std::max<size_t>(1, options.min_block_bytes / sizeof(int));
+    size_t fan_in = options.memory_limit_bytes / (2 * min_block_elements * sizeof(int));
+    size_t max_fan_in = std::min(options.max_fan_in, openFileBudget());
+    fan_in = std::clamp<size_t>(fan_in > 0 ? fan_in - 1 : 0, 2, std::max<size_t>(2, max_fan_in));
+    auto block_elements_for = [&](size_t k) {
+        return std::max(options.memory_limit_bytes / (sizeof(int) * 2 * (k + 1)), min_block_elements);
+    };
+
+    std::vector<std::string> level = runs.paths;
+    while (level.size() > fan_in) {
+        std::vector<std::string> next;
+        for (size_t first = 0; first < level.size(); first += fan_in) {
+            std::vector<std::string> group(level.begin() + first,
+                                           level.begin() + std::min(level.size(), first + fan_in));
+            if (group.size() == 1) {
+                next.push_back(group.front());
+                continue;
+            }
+            std::string path = run_prefix + std::to_string(runs.paths.size()) + ".run";
+            runs.paths.push_back(path);
+            if (!mergeRunFiles(group, path, block_elements_for(group.size()), pool)) {
+                return false;
+            }
+            for (const auto &merged: group) {
+                std::filesystem::remove(merged, error);
+            }
+            next.push_back(path);
+        }
+        level.swap(next);
+        stats.merge_passes++;
+    }
+
+    if (!mergeRunFiles(level, output_path, block_elements_for(level.size()), pool)) {
+        return false;
+    }
+    stats.merge_phase_seconds = secondsSince(merge_start);
+    return true;
+}
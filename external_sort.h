@@ -0,0 +1,45 @@
+#ifndef EXTERNAL_SORT_H
+#define EXTERNAL_SORT_H
+
+#include <cstddef>
+#include <string>
+
+class ThreadPool;
+
+// Tuning for externalSort
+struct ExternalSortOptions {
+    size_t memory_limit_bytes = size_t(256) << 20;   // total budget for run buffers and merge blocks
+    std::string temp_directory;                      // where sorted runs are spilled; empty = system temp
+    size_t min_block_bytes = size_t(64) << 10;       // smallest per-run read block during the merge
+    size_t max_fan_in = 256;                         // most runs merged at once; each holds an open file
+};
+
+// What externalSort did and how fast
+struct ExternalSortStats {
+    size_t elements = 0;
+    size_t runs = 0;
+    size_t merge_passes = 0;            // intermediate passes before the final merge
+    double run_phase_seconds = 0.0;     // read + sort + spill
+    double merge_phase_seconds = 0.0;   // k-way merge to the output file
+
+    double totalSeconds() const { return run_phase_seconds + merge_phase_seconds; }
+
+    // Input bytes per second over the whole sort
+    double throughputMBps() const;
+};
+
+// Sort a binary file of native-endian int32 keys that may be larger than RAM.
+// Chunks that fit the memory limit are sorted with mergeSortThreadPool and
+// spilled as runs, then k-way merged with large sequential buffered I/O while
+// the pool prefetches the next block of every run and writes out full output
+// blocks in the background. Every merged run and the output hold two blocks of
+// at least min_block_bytes, so one merge takes at most
+// memory_limit_bytes / (2 * min_block_bytes) - 1 runs (and at most max_fan_in,
+// or what the open file limit allows); more
+// runs are merged in several passes through intermediate run files. Memory use
+// is therefore bounded by the limit, but never below six minimum blocks.
+// Returns false (with a message on stderr) on I/O errors.
+bool externalSort(const std::string &input_path, const std::string &output_path,
+                  const ExternalSortOptions &options, ThreadPool &pool, ExternalSortStats &stats);
+
+#endif // EXTERNAL_SORT_H
@@ -0,0 +1,165 @@
+#include "isolation.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SORT_BENCH_HAS_FORK 1
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+bool isolationSupported() {
+#ifdef SORT_BENCH_HAS_FORK
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool parseCpuSet(const std::string &text, std::vector<int> &cpus) {
+    std::stringstream stream(text);
+    std::string item;
+    cpus.clear();
+
+    while (std::getline(stream, item, ',')) {
+        if (item.empty()) return false;
+
+        char *end = nullptr;
+        long first = std::strtol(item.c_str(), &end, 10);
+        long last = first;
+        if (end == item.c_str() || first < 0) return false;
+        if (*end == '-') {
+            const char *range_end = end + 1;
+            last = std::strtol(range_end, &end, 10);
+            if (end == range_end || last < first) return false;
+        }
+        if (*end != '\0') return false;
+
+        for (long cpu = first; cpu <= last; cpu++) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+    return !cpus.empty();
+}
+
+bool pinToCpus(const std::vector<int> &cpus) {
+    if (cpus.empty()) return true;
+
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu: cpus) {
+        if (cpu >= CPU_SETSIZE) return false;
+        CPU_SET(cpu, &set);
+    }
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+void prefaultHeap(size_t bytes) {
+#ifdef __GLIBC__
+    // Keep large blocks on the heap instead of private mmaps, and never trim it,
+    // so pages faulted in here are reused by the sort's scratch allocations
+    mallopt(M_MMAP_THRESHOLD, 1 << 30);
+    mallopt(M_TRIM_THRESHOLD, -1);
+#endif
+    if (bytes == 0) return;
+
+    std::vector<unsigned char> block(bytes);
+    for (size_t i = 0; i < bytes; i += 4096) {
+        block[i] = 1;
+    }
+    // Keep the stores from being optimised away before the block is released
+    volatile unsigned char sink = block[bytes - 1];
+    (void) sink;
+}
+
+bool writeAll(int fd, const void *data, size_t size) {
+#ifdef SORT_BENCH_HAS_FORK
+    const char *ptr = static_cast<const char *>(data);
+    while (size > 0) {
+        ssize_t written = write(fd, ptr, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        ptr += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+#else
+    (void) fd;
+    (void) data;
+    (void) size;
+    return false;
+#endif
+}
+
+bool runInChild(const std::function<void(int out_fd)> &child, std::string &output) {
+#ifdef SORT_BENCH_HAS_FORK
+    int fds[2];
+    if (pipe(fds) != 0) {
+        std::cerr << "Error: pipe() failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Flush so buffered parent output is not duplicated by the child
+    std::cout.flush();
+    std::cerr.flush();
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        std::cerr << "Error: fork() failed: " << std::strerror(errno) << std::endl;
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+
+    if (pid == 0) {
+        close(fds[0]);
+        child(fds[1]);
+        close(fds[1]);
+        std::cout.flush();
+        std::cerr.flush();
+        _exit(0);
+    }
+
+    close(fds[1]);
+    output.clear();
+    char buffer[4096];
+    for (;;) {
+        ssize_t n = read(fds[0], buffer, sizeof(buffer));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        output.append(buffer, static_cast<size_t>(n));
+    }
+    close(fds[0]);
+
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+    }
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        std::cerr << "Error: Benchmark child process did not exit cleanly" << std::endl;
+        return false;
+    }
+    return true;
+#else
+    (void) child;
+    (void) output;
+    return false;
+#endif
+}
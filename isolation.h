@@ -0,0 +1,30 @@
+#ifndef ISOLATION_H
+#define ISOLATION_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+// True when this build can fork benchmark children (POSIX only)
+bool isolationSupported();
+
+// Parse a CPU list such as "0-3,6"; returns false on malformed input
+bool parseCpuSet(const std::string &text, std::vector<int> &cpus);
+
+// Pin the calling process (and the threads it creates later) to the given CPUs.
+// An empty set leaves the affinity unchanged. Returns false if pinning failed.
+bool pinToCpus(const std::vector<int> &cpus);
+
+// Touch and release `bytes` of heap so the timed region does not pay first-touch
+// page faults, and stop the allocator from handing that memory back to the OS
+void prefaultHeap(size_t bytes);
+
+// Run `child` in a forked process and collect the raw bytes it writes to `out_fd`.
+// Returns false if the fork failed or the child did not exit cleanly.
+bool runInChild(const std::function<void(int out_fd)> &child, std::string &output);
+
+// Write the whole buffer to a file descriptor, retrying on partial writes
+bool writeAll(int fd, const void *data, size_t size);
+
+#endif // ISOLATION_H
@@ -0,0 +1,166 @@
+#ifndef LOSER_TREE_H
+#define LOSER_TREE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <numeric>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+// One sorted input of a k-way merge: [begin, end)
+template<class T>
+struct MergeSource {
+    const T *begin;
+    const T *end;
+};
+
+// Tournament tree of losers over k sorted sources. Every internal node keeps
+// the head key of the source that lost the match played there, so after the
+// winner is consumed only its path to the root is replayed: log2(k) compares
+// of cached keys per output element, with no pointer chasing and no heap
+// sift-down. Ties go to the lower source index, so the merge is stable with
+// respect to source order. An exhausted source's head is the largest key with
+// a tag above every source index, so it loses to every real key.
+template<class T>
+class LoserTree {
+public:
+    explicit LoserTree(std::span<const MergeSource<T>> sources,
+                       std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+        : sources_(sources.begin(), sources.end(), resource), k_(sources.size()),
+          tree_(std::max<size_t>(k_, 1), resource) {
+        if (k_ > 0) {
+            winner_ = build(1);
+        }
+    }
+
+    // Write the next `count` elements of the merged sequence to out
+    void mergeInto(T *out, size_t count) {
+        mergeEach(count, [out](size_t i, T key) { out[i] = key; });
+    }
+
+    // Pass the next `count` elements of the merged sequence to emit(i, key) in order
+    template<class Emit>
+    void mergeEach(size_t count, Emit emit) {
+        for (size_t i = 0; i < count; i++) {
+            emit(i, winner_.key);
+            size_t source = winner_.tag & INDEX_MASK;
+            Node winner = head(source);
+            for (size_t node = (source + k_) / 2; node > 0; node /= 2) {
+                Node challenger = tree_[node];
+                bool challenger_wins = before(challenger, winner);
+                tree_[node] = challenger_wins ? winner : challenger;
+                winner = challenger_wins ? challenger : winner;
+            }
+            winner_ = winner;
+        }
+    }
+
+private:
+    static constexpr uint32_t EXHAUSTED = 1u << 31;
+    static constexpr uint32_t INDEX_MASK = EXHAUSTED - 1;
+
+    struct Node {
+        T key;
+        uint32_t tag;    // source index, with EXHAUSTED set once the source is empty
+    };
+
+    std::pmr::vector<MergeSource<T>> sources_;
+    size_t k_;
+    std::pmr::vector<Node> tree_;    // tree_[1..k) = losers
+    Node winner_{};
+
+    // Non-short-circuit operators keep this branch-free, so the replay compiles to conditional moves
+    static bool before(const Node &a, const Node &b) {
+        return (a.key < b.key) | ((a.key == b.key) & (a.tag < b.tag));
+    }
+
+    // Pop the next key of a source into a node
+    Node head(size_t source) {
+        MergeSource<T> &input = sources_[source];
+        if (input.begin == input.end) {
+            return {std::numeric_limits<T>::max(), static_cast<uint32_t>(source) | EXHAUSTED};
+        }
+        return {*input.begin++, static_cast<uint32_t>(source)};
+    }
+
+    // Nodes [k, 2k) are the leaves; returns the winner of the subtree at node
+    Node build(size_t node) {
+        if (node >= k_) return head(node - k_);
+        Node left = build(2 * node);
+        Node right = build(2 * node + 1);
+        if (before(left, right)) {
+            tree_[node] = right;
+            return left;
+        }
+        tree_[node] = left;
+        return right;
+    }
+};
+
+// Multi-sequence selection: find per-source split positions so that exactly
+// `rank` elements lie before the splits and none of them is greater than any
+// element after them. Merging the prefixes and the suffixes separately then
+// produces two adjacent slices of the full merge, which lets independent
+// workers each write a disjoint part of the output. Writes one split per
+// source to `splits`. Binary-searches the key domain, so it needs integral keys.
+template<class T>
+void multiSequenceSelect(std::span<const MergeSource<T>> sources, size_t rank, std::span<size_t> splits) {
+    static_assert(std::is_integral_v<T>, "multiSequenceSelect searches the key domain");
+
+    std::fill(splits.begin(), splits.end(), 0);
+    size_t total = 0;
+    bool any = false;
+    T low{}, high{};
+    for (const auto &source: sources) {
+        if (source.begin == source.end) continue;
+        total += source.end - source.begin;
+        low = any ? std::min(low, *source.begin) : *source.begin;
+        high = any ? std::max(high, *(source.end - 1)) : *(source.end - 1);
+        any = true;
+    }
+    if (rank == 0) return;
+    if (rank >= total) {
+        for (size_t i = 0; i < sources.size(); i++) {
+            splits[i] = sources[i].end - sources[i].begin;
+        }
+        return;
+    }
+
+    // Smallest key v with at least `rank` elements <= v
+    auto count_not_greater = [&sources](T value) {
+        size_t count = 0;
+        for (const auto &source: sources) {
+            count += std::upper_bound(source.begin, source.end, value) - source.begin;
+        }
+        return count;
+    };
+    while (low < high) {
+        T mid = std::midpoint(low, high);
+        if (count_not_greater(mid) >= rank) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+
+    // Everything below the key goes first; copies of the key fill up the
+    // remainder, taken from the lowest-indexed sources first
+    size_t taken = 0;
+    for (size_t i = 0; i < sources.size(); i++) {
+        splits[i] = std::lower_bound(sources[i].begin, sources[i].end, low) - sources[i].begin;
+        taken += splits[i];
+    }
+    size_t remaining = rank - taken;
+    for (size_t i = 0; i < sources.size() && remaining > 0; i++) {
+        size_t equal = (std::upper_bound(sources[i].begin, sources[i].end, low) - sources[i].begin) - splits[i];
+        size_t take = std::min(equal, remaining);
+        splits[i] += take;
+        remaining -= take;
+    }
+}
+
+#endif // LOSER_TREE_H
@@ -1,52 +1,263 @@
+#include <algorithm>
 #include <iostream>
-#include <functional>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
 #include "config.h"
+#include "cli.h"
+#include "algorithm_registry.h"
 #include "benchmark.h"
-#include "sorting_algorithms.h"
+#include "isolation.h"
+#include "mapped_sort.h"
+#include "distributed_sort.h"
+#include "timer.h"
 #include "ThreadPool.h"
 
-int main() {
-    BenchmarkConfig config;
+int main(int argc, char **argv) {
+    CommandLineOptions options;
+    if (!parseCommandLine(argc, argv, options)) {
+        return 2;
+    }
+    if (options.show_help) {
+        printUsage(argv[0]);
+        return 0;
+    }
+
+    BenchmarkConfig &config = options.config;
+
+    if (config.mode != BenchmarkMode::Sort && config.isolation != IsolationMode::None) {
+        std::cerr << "WARNING: Only sort mode supports isolation; ignoring --isolate" << std::endl;
+        config.isolation = IsolationMode::None;
+    }
+
+    if (config.mode == BenchmarkMode::Mapped && !mappedSortSupported()) {
+        std::cerr << "Error: --mode mmap needs memory-mapped files, which this platform lacks" << std::endl;
+        return 2;
+    }
+
+    if (config.mode == BenchmarkMode::Distributed && !distributedSortSupported()) {
+        std::cerr << "Error: --mode distributed needs Unix sockets and POSIX shared memory, which this platform lacks"
+                << std::endl;
+        return 2;
+    }
+
+    if (config.isolation != IsolationMode::None && !isolationSupported()) {
+        std::cerr << "WARNING: Process isolation is not supported on this platform; running in-process"
+                << std::endl;
+        config.isolation = IsolationMode::None;
+    }
+
+    const std::vector<AlgorithmInfo> &registered = AlgorithmRegistry::instance().algorithms();
+
+    if (options.list_algorithms) {
+        for (const auto &info: registered) {
+            std::cout << info.id << "\t" << info.name << "\t"
+                    << (info.has(CAP_STABLE) ? "stable " : "")
+                    << (info.has(CAP_IN_PLACE) ? "in-place " : "")
+                    << (info.has(CAP_PARALLEL) ? "parallel " : "")
+                    << (info.has(CAP_SEGMENTED) ? "segmented " : "")
+                    << ((info.key_types & KEY_INT64) ? "int64 " : "")
+                    << "extra " << extraMemoryName(info.extra_memory) << std::endl;
+        }
+        return 0;
+    }
+
+    // Keep only the algorithms for this mode that were selected on the command line
+    bool segmented_mode = config.mode == BenchmarkMode::Segmented;
+    bool file_mode = config.mode == BenchmarkMode::External || config.mode == BenchmarkMode::Mapped;
+    bool registry_mode = config.mode == BenchmarkMode::Sort || segmented_mode;
+    std::vector<const AlgorithmInfo *> algorithms;
+    for (const auto &info: registered) {
+        if (!registry_mode) break;
+        if (info.has(CAP_SEGMENTED) != segmented_mode) continue;
+
+        bool selected = options.algorithm_patterns.empty();
+        for (const auto &pattern: options.algorithm_patterns) {
+            if (matchesPattern(info.id, pattern) || matchesPattern(info.name, pattern)) {
+                selected = true;
+                break;
+            }
+        }
+        if (selected) {
+            algorithms.push_back(&info);
+        }
+    }
+    if (algorithms.empty() && registry_mode) {
+        std::cerr << "Error: No algorithm matches the --algorithms selection (see --list)" << std::endl;
+        return 2;
+    }
+
+    std::vector<size_t> sizes = options.sizes;
+    if (sizes.empty()) {
+        sizes.push_back(config.array_size);
+    }
+    std::vector<Distribution> distributions = options.distributions;
+    if (distributions.empty()) {
+        distributions.push_back(config.distribution);
+    }
 
     std::cout << "========================================" << std::endl;
     std::cout << "SORTING ALGORITHM BENCHMARK" << std::endl;
     std::cout << "========================================" << std::endl;
     std::cout << "Configuration:" << std::endl;
-    std::cout << "  Array size: " << config.array_size << " elements" << std::endl;
+    std::cout << "  Array size:";
+    for (size_t size: sizes) {
+        std::cout << " " << size;
+    }
+    std::cout << " elements" << std::endl;
+    std::cout << "  Distribution:";
+    for (Distribution distribution: distributions) {
+        std::cout << " " << distributionName(distribution);
+    }
+    std::cout << std::endl;
     std::cout << "  Iterations: " << config.iterations << " per algorithm" << std::endl;
     std::cout << "  Thread count: " << config.thread_count << std::endl;
     std::cout << "  ThreadPool size: " << config.threadpool_size << std::endl;
-    std::cout << "  Output file: " << config.output_file << std::endl;
+    if (file_mode) {
+        std::cout << "  File sort: " << (config.external_input ? config.external_input : "generated input");
+        if (config.mode == BenchmarkMode::External) {
+            std::cout << ", memory cap " << (config.memory_cap >> 20) << " MB";
+        } else {
+            std::cout << ", " << config.key_bits << "-bit keys, mmap vs read-sort-write";
+        }
+        std::cout << std::endl;
+    } else if (config.mode == BenchmarkMode::Select) {
+        std::cout << "  Selection: k = " << config.select_k << ", against a full sort" << std::endl;
+    } else if (config.mode == BenchmarkMode::Distributed) {
+        std::cout << "  Distributed: " << config.distributed_workers << " worker processes, sample sort" << std::endl;
+    } else if (config.mode == BenchmarkMode::Strings) {
+        std::cout << "  Strings: std::sort, multikey quicksort and MSD radix, sequential and on the pool" << std::endl;
+    } else {
+        std::cout << "  Algorithms: " << algorithms.size() << std::endl;
+    }
+    if (segmented_mode) {
+        std::cout << "  Segments: " << config.segment_min << "-" << config.segment_max << " elements" << std::endl;
+    }
+    std::cout << "  Timer: " << PrecisionTimer::instance().description() << std::endl;
+    if (config.isolation != IsolationMode::None) {
+        std::cout << "  Isolation: one process per "
+                << (config.isolation == IsolationMode::Trial ? "trial" : "algorithm")
+                << (config.cpu_set ? std::string(", CPUs ") + config.cpu_set : std::string()) << std::endl;
+    }
+    if (config.shuffle_order) {
+        std::cout << "  Run order: shuffled" << std::endl;
+    }
+    if (config.reuse_scratch) {
+        std::cout << "  Scratch memory: reused across iterations" << std::endl;
+    }
+    if (config.output_format != OutputFormat::None) {
+        std::cout << "  Output file: " << config.output_file << std::endl;
+    }
     std::cout << "========================================\n" << std::endl;
 
-    // Create ThreadPool for ThreadPool-based merge sort
-    ThreadPool pool(config.threadpool_size);
+    // Create ThreadPool for ThreadPool-based sorts and bind every selected algorithm to it.
+    // Isolated children build their own pool, since threads do not survive fork().
+    std::unique_ptr<ThreadPool> pool;
+    std::vector<SortFunction> sort_functions;
+    std::vector<SegmentedSortFunction> segmented_functions;
+    if (config.isolation == IsolationMode::None) {
+        pool = std::make_unique<ThreadPool>(config.threadpool_size);
+        SortEnvironment environment{*pool, config.thread_count, config.reuse_scratch};
+        for (const AlgorithmInfo *info: algorithms) {
+            if (segmented_mode) {
+                segmented_functions.push_back(info->segmented_factory(environment));
+            } else {
+                sort_functions.push_back(info->factory(environment));
+            }
+        }
+    }
 
     // Create benchmark runner
     BenchmarkRunner benchmark(config);
 
-    // Run benchmarks for each algorithm
-    benchmark.runAlgorithm("Single-Threaded Merge Sort", mergeSortSingleThreaded);
+    std::mt19937 order_gen(config.random_seed);
+    std::vector<size_t> order(algorithms.size());
+    std::iota(order.begin(), order.end(), 0);
 
-    benchmark.runAlgorithm("Multi-Threaded Merge Sort (Recursive)", [&config](std::vector<int> &arr) {
-        mergeSortMultiThreaded(arr, config.thread_count);
-    });
+    // File, selection, distributed and string modes run a fixed set of methods instead of registry algorithms.
+    // File modes sort the given file, or one generated input per sweep point.
+    auto run_methods = [&]() {
+        if (config.mode == BenchmarkMode::Mapped) {
+            benchmark.runMappedSort(*pool);
+        } else if (config.mode == BenchmarkMode::External) {
+            benchmark.runExternalSort(*pool);
+        } else if (config.mode == BenchmarkMode::Distributed) {
+            benchmark.runDistributedSort();
+        } else if (config.mode == BenchmarkMode::Strings) {
+            benchmark.runStringSort(*pool);
+        } else {
+            benchmark.runSelection(*pool);
+        }
+    };
+    if (file_mode && config.external_input) {
+        run_methods();
+    } else if (!registry_mode) {
+        for (size_t size: sizes) {
+            benchmark.setArraySize(size);
+            for (Distribution distribution: distributions) {
+                benchmark.setDistribution(distribution);
+                run_methods();
+            }
+        }
+    }
 
-    benchmark.runAlgorithm("Multi-Threaded Merge Sort (ThreadPool)", [&pool](std::vector<int> &arr) {
-        mergeSortThreadPool(arr, pool);
-    });
+    // Run benchmarks for each selected algorithm at every sweep point
+    for (size_t size: sizes) {
+        benchmark.setArraySize(size);
+        for (Distribution distribution: distributions) {
+            benchmark.setDistribution(distribution);
 
-    benchmark.runAlgorithm("Quick Sort", quickSort);
+            if (config.isolation == IsolationMode::Trial) {
+                // Interleave trials so no algorithm always runs first or last
+                for (int iteration = 1; iteration <= config.iterations; iteration++) {
+                    if (config.shuffle_order) {
+                        std::shuffle(order.begin(), order.end(), order_gen);
+                    }
+                    for (size_t index: order) {
+                        benchmark.runAlgorithmIsolated(*algorithms[index], iteration, 1);
+                    }
+                }
+                continue;
+            }
 
-    benchmark.runAlgorithm("Heap Sort", heapSort);
-
-    benchmark.runAlgorithm("STL Sort (std::sort)", stlSort);
+            if (config.shuffle_order) {
+                std::shuffle(order.begin(), order.end(), order_gen);
+            }
+            for (size_t index: order) {
+                if (segmented_mode) {
+                    benchmark.runSegmented(algorithms[index]->name, segmented_functions[index]);
+                } else if (config.isolation == IsolationMode::Algorithm) {
+                    benchmark.runAlgorithmIsolated(*algorithms[index], 1, config.iterations);
+                } else {
+                    benchmark.runAlgorithm(algorithms[index]->name, sort_functions[index]);
+                }
+            }
+        }
+    }
 
     // Print summary statistics
     benchmark.printSummary();
 
-    // Export results to CSV
-    benchmark.exportToCSV();
+    // Export results in the selected format
+    benchmark.exportResults();
+
+    // Save and/or check against a stored baseline
+    // Exit codes: 1 = regression, 2 = the baseline could not be written or read
+    if (config.baseline_save_file && !benchmark.saveBaseline(config.baseline_save_file)) {
+        return 2;
+    }
+
+    if (config.baseline_compare_file) {
+        BaselineComparison comparison = benchmark.compareToBaseline(config.baseline_compare_file);
+        if (comparison == BaselineComparison::Error) {
+            return 2;
+        }
+        if (comparison == BaselineComparison::Regression) {
+            return 1;
+        }
+    }
 
     std::cout << "\nBenchmark completed successfully!" << std::endl;
 
@@ -0,0 +1,229 @@
+#include "mapped_sort.h"
+#include "sorting_algorithms.h"
+#include "ThreadPool.h"
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <span>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SORT_BENCH_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sys/vfs.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Sort `bytes` of keys at `data` in place
+void sortKeys(void *data, size_t bytes, KeyWidth width, ThreadPool &pool) {
+    if (width == KeyWidth::Int64) {
+        mergeSortThreadPool(std::span<int64_t>(static_cast<int64_t *>(data), bytes / sizeof(int64_t)), pool);
+    } else {
+        mergeSortThreadPool(std::span<int>(static_cast<int *>(data), bytes / sizeof(int)), pool);
+    }
+}
+
+// Size of the key file, rejecting files that are not a whole number of keys
+bool keyFileSize(const std::string &path, KeyWidth width, size_t &bytes) {
+    std::error_code error;
+    uintmax_t size = std::filesystem::file_size(path, error);
+    if (error) {
+        std::cerr << "Error: Could not stat " << path << ": " << error.message() << std::endl;
+        return false;
+    }
+    if (size % keyBytes(width) != 0) {
+        std::cerr << "Error: " << path << " is not a whole number of " << keyBytes(width) * 8
+                << "-bit keys" << std::endl;
+        return false;
+    }
+    bytes = static_cast<size_t>(size);
+    return true;
+}
+
+#ifdef SORT_BENCH_HAS_MMAP
+
+// hugetlbfs mappings are always backed by huge pages, no advice needed
+bool onHugetlbfs(int fd) {
+#ifdef __linux__
+    constexpr long HUGETLBFS_MAGIC = 0x958458f6;
+    struct statfs info{};
+    return fstatfs(fd, &info) == 0 && static_cast<long>(info.f_type) == HUGETLBFS_MAGIC;
+#else
+    (void) fd;
+    return false;
+#endif
+}
+
+// Bytes of [start, start + length) mapped with huge (PMD-sized) pages, summed
+// over the VMAs that overlap it in /proc/self/smaps; 0 where that is unavailable
+size_t hugePageBytes(const void *start, size_t length) {
+#ifdef __linux__
+    std::ifstream smaps("/proc/self/smaps");
+    unsigned long long first = reinterpret_cast<uintptr_t>(start);
+    unsigned long long last = first + length;
+    static constexpr const char *HUGE_FIELDS[] = {"AnonHugePages:", "ShmemPmdMapped:", "FilePmdMapped:"};
+    bool overlaps = false;
+    size_t kilobytes = 0;
+    std::string line;
+    while (std::getline(smaps, line)) {
+        // VMA headers look like "7f12a0000000-7f12b0000000 rw-s ..."
+        unsigned long long begin = 0, end = 0;
+        if (std::sscanf(line.c_str(), "%llx-%llx ", &begin, &end) == 2) {
+            overlaps = begin < last && end > first;
+            continue;
+        }
+        if (!overlaps) continue;
+        for (const char *field: HUGE_FIELDS) {
+            size_t field_length = std::strlen(field);
+            if (line.compare(0, field_length, field) == 0) {
+                kilobytes += std::strtoull(line.c_str() + field_length, nullptr, 10);
+            }
+        }
+    }
+    return kilobytes * 1024;
+#else
+    (void) start;
+    (void) length;
+    return 0;
+#endif
+}
+
+#endif
+
+} // namespace
+
+double FileSortStats::throughputMBps() const {
+    double seconds = totalSeconds();
+    if (seconds <= 0.0) return 0.0;
+    return static_cast<double>(file_bytes) / (1024.0 * 1024.0) / seconds;
+}
+
+bool mappedSortSupported() {
+#ifdef SORT_BENCH_HAS_MMAP
+    return true;
+#else
+    return false;
+#endif
+}
+
+size_t keyBytes(KeyWidth width) {
+    return width == KeyWidth::Int64 ? sizeof(int64_t) : sizeof(int);
+}
+
+bool sortFileMapped(const std::string &path, KeyWidth width, const MappedSortOptions &options,
+                    ThreadPool &pool, FileSortStats &stats) {
+    stats = FileSortStats();
+    if (!keyFileSize(path, width, stats.file_bytes)) return false;
+    stats.elements = stats.file_bytes / keyBytes(width);
+    if (stats.file_bytes == 0) return true;
+
+#ifdef SORT_BENCH_HAS_MMAP
+    auto load_start = Clock::now();
+    int fd = open(path.c_str(), O_RDWR);
+    if (fd < 0) {
+        std::cerr << "Error: Could not open " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+    if (options.populate) flags |= MAP_POPULATE;
+#endif
+    void *data = mmap(nullptr, stats.file_bytes, PROT_READ | PROT_WRITE, flags, fd, 0);
+    if (data == MAP_FAILED) {
+        std::cerr << "Error: Could not map " << path << ": " << std::strerror(errno) << std::endl;
+        close(fd);
+        return false;
+    }
+
+    stats.huge_pages = onHugetlbfs(fd);
+#ifdef MADV_HUGEPAGE
+    // Linux accepts the advice on any mapping, but only some page caches act on
+    // it (e.g. tmpfs mounted with huge=advise), so smaps says what actually happened
+    if (options.huge_pages && !stats.huge_pages) {
+        madvise(data, stats.file_bytes, MADV_HUGEPAGE);
+    }
+#endif
+#ifndef MAP_POPULATE
+    if (options.populate) madvise(data, stats.file_bytes, MADV_WILLNEED);
+#endif
+    close(fd);
+    stats.load_seconds = secondsSince(load_start);
+
+    auto sort_start = Clock::now();
+    sortKeys(data, stats.file_bytes, width, pool);
+    stats.sort_seconds = secondsSince(sort_start);
+    stats.huge_pages = stats.huge_pages || hugePageBytes(data, stats.file_bytes) > 0;
+
+    auto store_start = Clock::now();
+    bool ok = msync(data, stats.file_bytes, MS_SYNC) == 0;
+    if (!ok) {
+        std::cerr << "Error: Could not sync " << path << ": " << std::strerror(errno) << std::endl;
+    }
+    munmap(data, stats.file_bytes);
+    stats.store_seconds = secondsSince(store_start);
+    return ok;
+#else
+    (void) options;
+    (void) pool;
+    std::cerr << "Error: Memory-mapped sorting is not supported on this platform" << std::endl;
+    return false;
+#endif
+}
+
+bool sortFileBuffered(const std::string &path, KeyWidth width, ThreadPool &pool, FileSortStats &stats) {
+    stats = FileSortStats();
+    if (!keyFileSize(path, width, stats.file_bytes)) return false;
+    stats.elements = stats.file_bytes / keyBytes(width);
+
+    auto load_start = Clock::now();
+    // int64_t storage is suitably aligned for either key width
+    std::vector<int64_t> buffer((stats.file_bytes + sizeof(int64_t) - 1) / sizeof(int64_t));
+    std::FILE *file = std::fopen(path.c_str(), "r+b");
+    if (!file) {
+        std::cerr << "Error: Could not open " << path << std::endl;
+        return false;
+    }
+    if (std::fread(buffer.data(), 1, stats.file_bytes, file) != stats.file_bytes) {
+        std::cerr << "Error: Short read from " << path << std::endl;
+        std::fclose(file);
+        return false;
+    }
+    stats.load_seconds = secondsSince(load_start);
+
+    auto sort_start = Clock::now();
+    sortKeys(buffer.data(), stats.file_bytes, width, pool);
+    stats.sort_seconds = secondsSince(sort_start);
+
+    auto store_start = Clock::now();
+    std::rewind(file);
+    bool ok = std::fwrite(buffer.data(), 1, stats.file_bytes, file) == stats.file_bytes &&
+              std::fflush(file) == 0;
+#ifdef SORT_BENCH_HAS_MMAP
+    ok = ok && fsync(fileno(file)) == 0;
+#endif
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        std::cerr << "Error: Failed writing " << path << std::endl;
+    }
+    stats.store_seconds = secondsSince(store_start);
+    return ok;
+}
@@ -0,0 +1,53 @@
+#ifndef MAPPED_SORT_H
+#define MAPPED_SORT_H
+
+#include <cstddef>
+#include <string>
+
+class ThreadPool;
+
+// Width of the native-endian signed keys stored in a binary key file
+enum class KeyWidth {
+    Int32,
+    Int64
+};
+
+// Hints for sortFileMapped
+struct MappedSortOptions {
+    bool populate = true;      // pre-fault the whole mapping (MAP_POPULATE / MADV_WILLNEED)
+    bool huge_pages = true;    // ask for huge pages where the filesystem supports them
+};
+
+// Where the time went in a file-to-file sort
+struct FileSortStats {
+    size_t elements = 0;
+    size_t file_bytes = 0;
+    double load_seconds = 0.0;    // mmap + populate, or read into memory
+    double sort_seconds = 0.0;
+    double store_seconds = 0.0;   // msync, or write back + fsync
+    bool huge_pages = false;      // the mapping was backed by huge pages (hugetlbfs, or PMD mappings in smaps)
+
+    double totalSeconds() const { return load_seconds + sort_seconds + store_seconds; }
+
+    // File bytes per second over the whole sort
+    double throughputMBps() const;
+};
+
+// True when this build can memory-map files (POSIX only)
+bool mappedSortSupported();
+
+// Size in bytes of one key of the given width
+size_t keyBytes(KeyWidth width);
+
+// Memory-map a binary key file read-write, sort it in place with
+// mergeSortThreadPool and msync the result back. No copy of the keys is made;
+// only the merge scratch buffer is allocated. Returns false (with a message on
+// stderr) on I/O errors.
+bool sortFileMapped(const std::string &path, KeyWidth width, const MappedSortOptions &options,
+                    ThreadPool &pool, FileSortStats &stats);
+
+// The conventional path for comparison: read the file into a vector, sort it
+// with mergeSortThreadPool and write it back with an fsync
+bool sortFileBuffered(const std::string &path, KeyWidth width, ThreadPool &pool, FileSortStats &stats);
+
+#endif // MAPPED_SORT_H
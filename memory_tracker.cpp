@@ -0,0 +1,235 @@
+#include "memory_tracker.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+// ============================================
+// Global allocation counters
+// ============================================
+
+namespace {
+
+std::atomic<size_t> g_allocation_count{0};
+std::atomic<size_t> g_bytes_allocated{0};
+std::atomic<size_t> g_live_bytes{0};
+std::atomic<size_t> g_peak_live_bytes{0};
+std::atomic<size_t> g_scratch_allocation_count{0};
+std::atomic<size_t> g_scratch_bytes_allocated{0};
+
+// Every block carries a header in front of the user pointer recording the
+// requested size (for the live-byte counter) and the pointer malloc returned
+// (so over-aligned blocks can be freed).
+struct alignas(alignof(std::max_align_t)) BlockHeader {
+    void *raw;
+    size_t size;
+};
+
+void recordAllocation(size_t size) {
+    g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+    g_bytes_allocated.fetch_add(size, std::memory_order_relaxed);
+    size_t live = g_live_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+
+    size_t peak = g_peak_live_bytes.load(std::memory_order_relaxed);
+    while (live > peak && !g_peak_live_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+void *trackedAlloc(size_t size, size_t alignment) {
+    if (alignment < alignof(BlockHeader)) {
+        alignment = alignof(BlockHeader);
+    }
+
+    void *raw = std::malloc(size + sizeof(BlockHeader) + alignment - alignof(BlockHeader));
+    if (!raw) return nullptr;
+
+    uintptr_t user = reinterpret_cast<uintptr_t>(raw) + sizeof(BlockHeader);
+    user = (user + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+
+    BlockHeader *header = reinterpret_cast<BlockHeader *>(user) - 1;
+    header->raw = raw;
+    header->size = size;
+
+    recordAllocation(size);
+    return reinterpret_cast<void *>(user);
+}
+
+void trackedFree(void *ptr) noexcept {
+    if (!ptr) return;
+
+    BlockHeader *header = static_cast<BlockHeader *>(ptr) - 1;
+    g_live_bytes.fetch_sub(header->size, std::memory_order_relaxed);
+    std::free(header->raw);
+}
+
+void *allocOrThrow(size_t size, size_t alignment) {
+    if (size == 0) size = 1;
+
+    for (;;) {
+        if (void *ptr = trackedAlloc(size, alignment)) {
+            return ptr;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+// ============================================
+// Resident set size
+// ============================================
+
+#ifdef __linux__
+// Read a "Key:   1234 kB" line from /proc/self/status
+size_t readProcStatusKb(const char *key) {
+    FILE *file = std::fopen("/proc/self/status", "r");
+    if (!file) return 0;
+
+    char line[256];
+    size_t key_len = std::strlen(key);
+    size_t value = 0;
+    while (std::fgets(line, sizeof(line), file)) {
+        if (std::strncmp(line, key, key_len) == 0 && line[key_len] == ':') {
+            value = std::strtoull(line + key_len + 1, nullptr, 10);
+            break;
+        }
+    }
+    std::fclose(file);
+    return value * 1024;
+}
+
+// Writing "5" to clear_refs resets VmHWM to the current RSS (Linux 4.0+)
+bool resetPeakRss() {
+    FILE *file = std::fopen("/proc/self/clear_refs", "w");
+    if (!file) return false;
+    bool ok = std::fputs("5", file) >= 0;
+    return std::fclose(file) == 0 && ok;
+}
+#endif
+
+size_t currentRssBytes() {
+#ifdef __linux__
+    return readProcStatusKb("VmRSS");
+#else
+    return 0;
+#endif
+}
+
+size_t peakRssBytes() {
+#ifdef __linux__
+    if (size_t hwm = readProcStatusKb("VmHWM")) {
+        return hwm;
+    }
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+        return static_cast<size_t>(usage.ru_maxrss);        // bytes
+#else
+        return static_cast<size_t>(usage.ru_maxrss) * 1024;  // kilobytes
+#endif
+    }
+#endif
+    return 0;
+}
+
+} // namespace
+
+// ============================================
+// Replacement operator new/delete
+// ============================================
+
+void *operator new(size_t size) {
+    return allocOrThrow(size, alignof(std::max_align_t));
+}
+
+void *operator new[](size_t size) {
+    return allocOrThrow(size, alignof(std::max_align_t));
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+    return trackedAlloc(size ? size : 1, alignof(std::max_align_t));
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+    return trackedAlloc(size ? size : 1, alignof(std::max_align_t));
+}
+
+void *operator new(size_t size, std::align_val_t alignment) {
+    return allocOrThrow(size, static_cast<size_t>(alignment));
+}
+
+void *operator new[](size_t size, std::align_val_t alignment) {
+    return allocOrThrow(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void *ptr) noexcept { trackedFree(ptr); }
+void operator delete[](void *ptr) noexcept { trackedFree(ptr); }
+void operator delete(void *ptr, size_t) noexcept { trackedFree(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { trackedFree(ptr); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept { trackedFree(ptr); }
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept { trackedFree(ptr); }
+void operator delete(void *ptr, std::align_val_t) noexcept { trackedFree(ptr); }
+void operator delete[](void *ptr, std::align_val_t) noexcept { trackedFree(ptr); }
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept { trackedFree(ptr); }
+void operator delete[](void *ptr, size_t, std::align_val_t) noexcept { trackedFree(ptr); }
+
+// ============================================
+// MemoryRegion
+// ============================================
+
+MemoryRegion::MemoryRegion() {
+#ifdef __linux__
+    peak_rss_reset_ = resetPeakRss();
+#else
+    peak_rss_reset_ = false;
+#endif
+    start_rss_bytes_ = currentRssBytes();
+    start_peak_rss_bytes_ = peakRssBytes();
+
+    start_allocation_count_ = g_allocation_count.load(std::memory_order_relaxed);
+    start_bytes_allocated_ = g_bytes_allocated.load(std::memory_order_relaxed);
+    start_scratch_allocation_count_ = g_scratch_allocation_count.load(std::memory_order_relaxed);
+    start_scratch_bytes_allocated_ = g_scratch_bytes_allocated.load(std::memory_order_relaxed);
+    start_live_bytes_ = g_live_bytes.load(std::memory_order_relaxed);
+    g_peak_live_bytes.store(start_live_bytes_, std::memory_order_relaxed);
+}
+
+MemoryUsage MemoryRegion::finish() const {
+    MemoryUsage usage;
+    usage.allocation_count = g_allocation_count.load(std::memory_order_relaxed) - start_allocation_count_;
+    usage.bytes_allocated = g_bytes_allocated.load(std::memory_order_relaxed) - start_bytes_allocated_;
+    usage.scratch_allocation_count =
+            g_scratch_allocation_count.load(std::memory_order_relaxed) - start_scratch_allocation_count_;
+    usage.scratch_bytes_allocated =
+            g_scratch_bytes_allocated.load(std::memory_order_relaxed) - start_scratch_bytes_allocated_;
+
+    size_t peak_live = g_peak_live_bytes.load(std::memory_order_relaxed);
+    usage.peak_heap_bytes = peak_live > start_live_bytes_ ? peak_live - start_live_bytes_ : 0;
+
+    // Without a peak reset the high-water mark may predate this region, so only
+    // growth beyond the previous peak can be attributed to it
+    size_t peak_rss = peakRssBytes();
+    size_t reference = peak_rss_reset_ ? start_rss_bytes_ : start_peak_rss_bytes_;
+    usage.peak_rss_delta_bytes = peak_rss > reference ? peak_rss - reference : 0;
+
+    return usage;
+}
+
+size_t liveHeapBytes() {
+    return g_live_bytes.load(std::memory_order_relaxed);
+}
+
+void recordScratchAllocation(size_t bytes) {
+    g_scratch_allocation_count.fetch_add(1, std::memory_order_relaxed);
+    g_scratch_bytes_allocated.fetch_add(bytes, std::memory_order_relaxed);
+}
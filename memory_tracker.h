@@ -0,0 +1,45 @@
+#ifndef MEMORY_TRACKER_H
+#define MEMORY_TRACKER_H
+
+#include <cstddef>
+
+// Heap and resident-memory usage of one measured region
+struct MemoryUsage {
+    size_t allocation_count = 0;      // operator new calls, from all threads
+    size_t bytes_allocated = 0;       // total bytes requested through operator new
+    size_t scratch_allocation_count = 0;  // of those, blocks taken by sort scratch arenas
+    size_t scratch_bytes_allocated = 0;   // bytes in those blocks
+    size_t peak_heap_bytes = 0;       // peak live heap above the level at region start
+    size_t peak_rss_delta_bytes = 0;  // peak resident set above the RSS at region start
+};
+
+// Measures the memory used between construction and finish().
+// Allocation counts come from the global operator new/delete replacement in
+// memory_tracker.cpp and include allocations made by other threads (e.g. pool
+// workers). RSS peaks come from /proc/self/status (or getrusage) and are 0 on
+// platforms that expose neither.
+class MemoryRegion {
+public:
+    MemoryRegion();
+
+    MemoryUsage finish() const;
+
+private:
+    size_t start_allocation_count_;
+    size_t start_bytes_allocated_;
+    size_t start_scratch_allocation_count_;
+    size_t start_scratch_bytes_allocated_;
+    size_t start_live_bytes_;
+    size_t start_rss_bytes_;
+    size_t start_peak_rss_bytes_;
+    bool peak_rss_reset_;
+};
+
+// Current number of live heap bytes allocated through operator new
+size_t liveHeapBytes();
+
+// Called by scratch arenas for every block they take from operator new, so
+// reports can tell scratch growth apart from other allocations
+void recordScratchAllocation(size_t bytes);
+
+#endif // MEMORY_TRACKER_H
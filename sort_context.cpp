@@ -0,0 +1,163 @@
+#include "sort_context.h"
+#include "ThreadPool.h"
+#include "memory_tracker.h"
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+namespace {
+
+// Smallest block an arena asks the heap for
+constexpr size_t MIN_BLOCK_BYTES = 64 * 1024;
+
+std::byte *allocateBlock(size_t bytes) {
+    return static_cast<std::byte *>(::operator new(bytes, std::align_val_t(ScratchArena::ALIGNMENT)));
+}
+
+void freeBlock(std::byte *data) {
+    ::operator delete(data, std::align_val_t(ScratchArena::ALIGNMENT));
+}
+
+} // namespace
+
+// ============================================
+// ScratchArena
+// ============================================
+
+ScratchArena::~ScratchArena() {
+    for (const Block &block: blocks_) {
+        freeBlock(block.data);
+    }
+}
+
+void ScratchArena::release(Mark mark) {
+    current_ = mark.block;
+    offset_ = mark.offset;
+    if (current_ != 0 || offset_ != 0 || blocks_.size() <= 1) return;
+
+    // Everything the last sort needed fitted in these blocks, so one block of
+    // their combined size serves it without growing next time
+    size_t total = capacity();
+    for (const Block &block: blocks_) {
+        freeBlock(block.data);
+    }
+    blocks_.clear();
+    grow(total);
+}
+
+size_t ScratchArena::capacity() const {
+    size_t total = 0;
+    for (const Block &block: blocks_) {
+        total += block.size;
+    }
+    return total;
+}
+
+void ScratchArena::reserve(size_t bytes) {
+    if (current_ != 0 || offset_ != 0 || capacity() >= bytes) return;
+    for (const Block &block: blocks_) {
+        freeBlock(block.data);
+    }
+    blocks_.clear();
+    grow(bytes);
+}
+
+void ScratchArena::grow(size_t min_bytes) {
+    size_t bytes = std::max({min_bytes, 2 * capacity(), MIN_BLOCK_BYTES});
+    blocks_.push_back({allocateBlock(bytes), bytes});
+    current_ = blocks_.size() - 1;
+    offset_ = 0;
+    growths_++;
+    recordScratchAllocation(bytes);
+}
+
+void *ScratchArena::do_allocate(size_t bytes, size_t alignment) {
+    alignment = std::max(alignment, ALIGNMENT);
+    for (;;) {
+        if (current_ < blocks_.size()) {
+            const Block &block = blocks_[current_];
+            auto base = reinterpret_cast<uintptr_t>(block.data);
+            size_t start = ((base + offset_ + alignment - 1) & ~(alignment - 1)) - base;
+            if (start <= block.size && bytes <= block.size - start) {
+                offset_ = start + bytes;
+                return block.data + start;
+            }
+            // Blocks past the current one are still free after a release
+            if (current_ + 1 < blocks_.size()) {
+                current_++;
+                offset_ = 0;
+                continue;
+            }
+        }
+        grow(bytes + alignment);
+    }
+}
+
+// ============================================
+// SortContext
+// ============================================
+
+SortContext::SortContext() : pool_(nullptr) {
+    arenas_.push_back(std::make_unique<ScratchArena>());
+}
+
+SortContext::SortContext(const ThreadPool &pool) : pool_(&pool) {
+    for (size_t i = 0; i <= pool.size(); i++) {
+        arenas_.push_back(std::make_unique<ScratchArena>());
+    }
+}
+
+ScratchArena &SortContext::arena() {
+    size_t worker = pool_ ? pool_->currentWorkerIndex() : ThreadPool::NOT_A_WORKER;
+    return worker < arenas_.size() - 1 ? *arenas_[worker] : *arenas_.back();
+}
+
+size_t SortContext::capacity() const {
+    size_t total = 0;
+    for (const auto &arena: arenas_) {
+        total += arena->capacity();
+    }
+    return total;
+}
+
+size_t SortContext::growths() const {
+    size_t total = 0;
+    for (const auto &arena: arenas_) {
+        total += arena->growths();
+    }
+    return total;
+}
+
+void SortContext::sortFinished(const ScratchArena &arena) {
+    if (&arena != arenas_.back().get() || arenas_.size() == 1) return;
+
+    size_t largest = 0;
+    for (size_t worker = 0; worker + 1 < arenas_.size(); worker++) {
+        largest = std::max(largest, arenas_[worker]->capacity());
+    }
+    for (size_t worker = 0; worker + 1 < arenas_.size(); worker++) {
+        arenas_[worker]->reserve(largest);
+    }
+}
+
+// ============================================
+// ScratchScope
+// ============================================
+
+ScratchScope::ScratchScope(SortContext *ctx)
+    : ctx_(ctx),
+      arena_(ctx ? &ctx->arena() : nullptr),
+      resource_(arena_ ? static_cast<std::pmr::memory_resource *>(arena_) : std::pmr::new_delete_resource()) {
+    if (arena_) {
+        mark_ = arena_->mark();
+    }
+}
+
+ScratchScope::~ScratchScope() {
+    if (arena_) {
+        arena_->release(mark_);
+        if (mark_.block == 0 && mark_.offset == 0) {
+            ctx_->sortFinished(*arena_);
+        }
+    }
+}
@@ -0,0 +1,130 @@
+#ifndef SORT_CONTEXT_H
+#define SORT_CONTEXT_H
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+class ThreadPool;
+
+// Growable bump allocator for sort scratch memory, owned by one thread at a
+// time. Deallocation is a no-op; memory is handed back in stack order by
+// release(). Blocks are kept across sorts, so once the arena has grown to a
+// sort's peak footprint, repeating that sort allocates nothing.
+class ScratchArena final : public std::pmr::memory_resource {
+public:
+    // Every allocation starts on its own cache line
+    static constexpr size_t ALIGNMENT = 64;
+
+    // Position to roll back to
+    struct Mark {
+        size_t block;
+        size_t offset;
+    };
+
+    ScratchArena() = default;
+
+    ~ScratchArena() override;
+
+    ScratchArena(const ScratchArena &) = delete;
+
+    ScratchArena &operator=(const ScratchArena &) = delete;
+
+    Mark mark() const { return {current_, offset_}; }
+
+    // Hand back everything allocated since `mark` was taken. When the arena
+    // becomes empty and had to grow into several blocks, they are replaced by
+    // one block of their combined size.
+    void release(Mark mark);
+
+    // Bytes held across all blocks
+    size_t capacity() const;
+
+    // Number of times the arena asked the heap for memory
+    size_t growths() const { return growths_; }
+
+    // While nothing is allocated, make the arena one block of at least `bytes`
+    void reserve(size_t bytes);
+
+private:
+    struct Block {
+        std::byte *data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks_;
+    size_t current_ = 0;    // block being bumped
+    size_t offset_ = 0;     // first free byte in that block
+    size_t growths_ = 0;
+
+    void grow(size_t min_bytes);
+
+    void *do_allocate(size_t bytes, size_t alignment) override;
+
+    void do_deallocate(void *, size_t, size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+};
+
+// Reusable scratch memory for the sorts in sorting_algorithms.h: one arena per
+// worker of a pool plus one for the calling thread, kept across calls. Which
+// worker runs which task changes from call to call, so when a sort ends every
+// worker arena is grown to the largest one. Pass the same context to repeated
+// sorts and, after the first call of the largest size, they stop allocating
+// scratch memory. A context serves one sort at a time; contexts made for
+// another pool (or none) are ignored by pool sorts.
+class SortContext {
+public:
+    // A context for single-threaded sorts only
+    SortContext();
+
+    // A context for sorts on `pool`
+    explicit SortContext(const ThreadPool &pool);
+
+    // Arena of the calling thread: its own if it is a worker of the bound pool,
+    // otherwise the caller arena
+    ScratchArena &arena();
+
+    // True when tasks on this pool's workers can use their own arenas
+    bool serves(const ThreadPool &pool) const { return pool_ == &pool; }
+
+    // Bytes held across all arenas
+    size_t capacity() const;
+
+    // Heap allocations made by all arenas so far
+    size_t growths() const;
+
+    // Called when `arena` is empty again: if it is the caller arena, the sort
+    // and all its tasks are done, so size every worker arena for the next one
+    void sortFinished(const ScratchArena &arena);
+
+private:
+    const ThreadPool *pool_;
+    std::vector<std::unique_ptr<ScratchArena>> arenas_;    // [0, workers) per worker, then the caller
+};
+
+// Scratch memory of one sort or task. With a context, allocations come from
+// the calling thread's arena and are handed back when the scope ends; without
+// one they go to the global heap as usual. Declare it before the containers
+// that use resource(), so they are destroyed first.
+class ScratchScope {
+public:
+    explicit ScratchScope(SortContext *ctx);
+
+    ~ScratchScope();
+
+    ScratchScope(const ScratchScope &) = delete;
+
+    ScratchScope &operator=(const ScratchScope &) = delete;
+
+    std::pmr::memory_resource *resource() const { return resource_; }
+
+private:
+    SortContext *ctx_;
+    ScratchArena *arena_;
+    ScratchArena::Mark mark_{};
+    std::pmr::memory_resource *resource_;
+};
+
+#endif // SORT_CONTEXT_H
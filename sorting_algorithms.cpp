@@ -1,27 +1,62 @@
 #include "sorting_algorithms.h"
 #include "ThreadPool.h"
+#include "algorithm_registry.h"
+#include "loser_tree.h"
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <thread>
 #include <vector>
 #include <future>
+#include <cmath>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <type_traits>
+
+// ============================================
+// Index width
+// ============================================
+
+// The recursive sorts below are templates on their index type. Whole arrays
+// are sorted with size_t indices, and every sub-range shorter than this is
+// rebased to its first element and finished with uint32_t indices, so the
+// inner loops keep 32-bit arithmetic. 2^31 rather than 2^32 keeps 2 * i + 2
+// in heapify and right + 1 in the merges from wrapping.
+constexpr size_t INDEX32_LIMIT = size_t(1) << 31;
+
+// True when a wide-index call on [left, right] can continue on 32-bit indices
+template<class Index>
+constexpr bool narrowable(Index left, Index right) {
+    return !std::is_same_v<Index, uint32_t> && right - left < INDEX32_LIMIT;
+}
 
 // ============================================
 // Helper functions for merge sort
 // ============================================
 
-void merge(std::vector<int> &arr, int left, int mid, int right) {
-    int n1 = mid - left + 1;
-    int n2 = right - mid;
+// Merge arr[left, mid] and arr[mid + 1, right]. The halves are staged in
+// buffer[left, right] when a buffer is given, otherwise in fresh vectors.
+template<class Index>
+void merge(int *arr, Index left, Index mid, Index right, int *buffer) {
+    Index n1 = mid - left + 1;
+    Index n2 = right - mid;
 
-    std::vector<int> L(n1);
-    std::vector<int> R(n2);
+    std::vector<int> L_storage, R_storage;
+    if (!buffer) {
+        L_storage.resize(n1);
+        R_storage.resize(n2);
+    }
+    int *L = buffer ? buffer + left : L_storage.data();
+    int *R = buffer ? buffer + mid + 1 : R_storage.data();
 
-    for (int i = 0; i < n1; i++)
+    for (Index i = 0; i < n1; i++)
         L[i] = arr[left + i];
-    for (int j = 0; j < n2; j++)
+    for (Index j = 0; j < n2; j++)
         R[j] = arr[mid + 1 + j];
 
-    int i = 0, j = 0, k = left;
+    Index i = 0, j = 0, k = left;
 
     while (i < n1 && j < n2) {
         if (L[i] <= R[j]) {
@@ -47,23 +82,36 @@ void merge(std::vector<int> &arr, int left, int mid, int right) {
     }
 }
 
-void mergeSortHelper(std::vector<int> &arr, int left, int right) {
+template<class Index>
+void mergeSortHelper(int *arr, Index left, Index right, int *buffer) {
+    if (narrowable(left, right)) {
+        mergeSortHelper<uint32_t>(arr + left, 0, right - left, buffer ? buffer + left : nullptr);
+        return;
+    }
     if (left < right) {
-        int mid = left + (right - left) / 2;
+        Index mid = left + (right - left) / 2;
 
-        mergeSortHelper(arr, left, mid);
-        mergeSortHelper(arr, mid + 1, right);
-        merge(arr, left, mid, right);
+        mergeSortHelper(arr, left, mid, buffer);
+        mergeSortHelper(arr, mid + 1, right, buffer);
+        merge(arr, left, mid, right, buffer);
     }
 }
 
+// With a context, one reused buffer as long as the array stages every merge;
+// concurrent merges work on disjoint ranges of it
+std::pmr::vector<int> mergeBuffer(const std::vector<int> &arr, const ScratchScope &scope, SortContext *ctx) {
+    return std::pmr::vector<int>(ctx ? arr.size() : 0, scope.resource());
+}
+
 // ============================================
 // Single-threaded merge sort
 // ============================================
 
-void mergeSortSingleThreaded(std::vector<int> &arr) {
+void mergeSortSingleThreaded(std::vector<int> &arr, SortContext *ctx) {
     if (arr.size() > 1) {
-        mergeSortHelper(arr, 0, arr.size() - 1);
+        ScratchScope scope(ctx);
+        std::pmr::vector<int> buffer = mergeBuffer(arr, scope, ctx);
+        mergeSortHelper<size_t>(arr.data(), 0, arr.size() - 1, ctx ? buffer.data() : nullptr);
     }
 }
 
@@ -71,28 +119,36 @@ void mergeSortSingleThreaded(std::vector<int> &arr) {
 // Multi-threaded merge sort
 // ============================================
 
-void mergeSortMultiThreadedHelper(std::vector<int> &arr, int left, int right, int depth, int max_depth) {
+template<class Index>
+void mergeSortMultiThreadedHelper(int *arr, Index left, Index right, int depth, int max_depth, int *buffer) {
+    if (narrowable(left, right)) {
+        mergeSortMultiThreadedHelper<uint32_t>(arr + left, 0, right - left, depth, max_depth,
+                                               buffer ? buffer + left : nullptr);
+        return;
+    }
     if (left < right) {
-        int mid = left + (right - left) / 2;
+        Index mid = left + (right - left) / 2;
 
         // Use threads only up to max_depth to avoid thread explosion
         if (depth < max_depth) {
-            std::thread leftThread(mergeSortMultiThreadedHelper, std::ref(arr), left, mid, depth + 1, max_depth);
-            std::thread rightThread(mergeSortMultiThreadedHelper, std::ref(arr), mid + 1, right, depth + 1, max_depth);
+            std::thread leftThread(mergeSortMultiThreadedHelper<Index>, arr, left, mid, depth + 1, max_depth,
+                                   buffer);
+            std::thread rightThread(mergeSortMultiThreadedHelper<Index>, arr, mid + 1, right, depth + 1,
+                                    max_depth, buffer);
 
             leftThread.join();
             rightThread.join();
         } else {
             // Fall back to single-threaded for smaller subarrays
-            mergeSortHelper(arr, left, mid);
-            mergeSortHelper(arr, mid + 1, right);
+            mergeSortHelper(arr, left, mid, buffer);
+            mergeSortHelper(arr, mid + 1, right, buffer);
         }
 
-        merge(arr, left, mid, right);
+        merge(arr, left, mid, right, buffer);
     }
 }
 
-void mergeSortMultiThreaded(std::vector<int> &arr, int thread_count) {
+void mergeSortMultiThreaded(std::vector<int> &arr, int thread_count, SortContext *ctx) {
     if (arr.size() > 1) {
         // Calculate max depth based on desired thread count
         // Each level doubles the number of threads: 2^depth = thread_count
@@ -103,7 +159,10 @@ void mergeSortMultiThreaded(std::vector<int> &arr, int thread_count) {
             max_depth++;
         }
 
-        mergeSortMultiThreadedHelper(arr, 0, arr.size() - 1, 0, max_depth);
+        ScratchScope scope(ctx);
+        std::pmr::vector<int> buffer = mergeBuffer(arr, scope, ctx);
+        mergeSortMultiThreadedHelper<size_t>(arr.data(), 0, arr.size() - 1, 0, max_depth,
+                                             ctx ? buffer.data() : nullptr);
     }
 }
 
@@ -111,32 +170,48 @@ void mergeSortMultiThreaded(std::vector<int> &arr, int thread_count) {
 // Quick sort
 // ============================================
 
-int partition(std::vector<int> &arr, int low, int high) {
+template<class Index>
+Index partition(int *arr, Index low, Index high) {
     int pivot = arr[high];
-    int i = low - 1;
+    Index i = low;
 
-    for (int j = low; j < high; j++) {
+    for (Index j = low; j < high; j++) {
         if (arr[j] < pivot) {
-            i++;
             std::swap(arr[i], arr[j]);
+            i++;
         }
     }
-    std::swap(arr[i + 1], arr[high]);
-    return i + 1;
+    std::swap(arr[i], arr[high]);
+    return i;
 }
 
-void quickSortHelper(std::vector<int> &arr, int low, int high) {
-    if (low < high) {
-        int pi = partition(arr, low, high);
+// Recurses into the smaller side and loops on the larger one, so the stack
+// stays O(log n) even when the last-element pivot splits badly
+template<class Index>
+void quickSortHelper(int *arr, Index low, Index high) {
+    while (low < high) {
+        if (narrowable(low, high)) {
+            quickSortHelper<uint32_t>(arr + low, 0, high - low);
+            return;
+        }
+        Index pi = partition(arr, low, high);
 
-        quickSortHelper(arr, low, pi - 1);
-        quickSortHelper(arr, pi + 1, high);
+        // Unsigned indices: pi - 1 must not wrap below the range (the larger
+        // left side always has pi > low)
+        if (pi - low < high - pi) {
+            if (pi > low)
+                quickSortHelper(arr, low, pi - 1);
+            low = pi + 1;
+        } else {
+            quickSortHelper(arr, pi + 1, high);
+            high = pi - 1;
+        }
     }
 }
 
 void quickSort(std::vector<int> &arr) {
     if (arr.size() > 1) {
-        quickSortHelper(arr, 0, arr.size() - 1);
+        quickSortHelper<size_t>(arr.data(), 0, arr.size() - 1);
     }
 }
 
@@ -144,10 +219,11 @@ void quickSort(std::vector<int> &arr) {
 // Heap sort
 // ============================================
 
-void heapify(std::vector<int> &arr, int n, int i) {
-    int largest = i;
-    int left = 2 * i + 1;
-    int right = 2 * i + 2;
+template<class Index>
+void heapify(int *arr, Index n, Index i) {
+    Index largest = i;
+    Index left = 2 * i + 1;
+    Index right = 2 * i + 2;
 
     if (left < n && arr[left] > arr[largest])
         largest = left;
@@ -161,17 +237,28 @@ void heapify(std::vector<int> &arr, int n, int i) {
     }
 }
 
-void heapSort(std::vector<int> &arr) {
-    int n = arr.size();
-
+template<class Index>
+void heapSortRange(int *arr, Index n) {
     // Build max heap
-    for (int i = n / 2 - 1; i >= 0; i--)
+    for (Index i = n / 2; i-- > 0;)
         heapify(arr, n, i);
 
     // Extract elements from heap one by one
-    for (int i = n - 1; i > 0; i--) {
+    for (Index i = n - 1; i > 0; i--) {
         std::swap(arr[0], arr[i]);
-        heapify(arr, i, 0);
+        heapify(arr, i, Index(0));
+    }
+}
+
+// The heap spans the whole array, so the index width is chosen once up front
+void heapSort(std::vector<int> &arr) {
+    size_t n = arr.size();
+    if (n < 2) return;
+
+    if (n < INDEX32_LIMIT) {
+        heapSortRange<uint32_t>(arr.data(), n);
+    } else {
+        heapSortRange<size_t>(arr.data(), n);
     }
 }
 
@@ -183,74 +270,2133 @@ void stlSort(std::vector<int> &arr) {
     std::sort(arr.begin(), arr.end());
 }
 
+void stlSort(std::span<int> data) {
+    std::sort(data.begin(), data.end());
+}
+
+void stlSort(std::span<int64_t> data) {
+    std::sort(data.begin(), data.end());
+}
+
 // ============================================
 // ThreadPool-based merge sort
 // ============================================
 
-void mergeSortThreadPool(std::vector<int> &arr, ThreadPool &pool) {
-    if (arr.size() <= 1) return;
+namespace {
 
-    // --- Chunk Calculation (Unchanged) ---
-    constexpr size_t MIN_CHUNK_SIZE = 2048;
-    size_t num_chunks = (arr.size() + MIN_CHUNK_SIZE - 1) / MIN_CHUNK_SIZE;
-    if (num_chunks <= 1) {
-        mergeSortHelper(arr, 0, arr.size() - 1);
+constexpr size_t MIN_CHUNK_SIZE = 2048;
+
+// Below this length a chunk is finished by insertion sort
+constexpr size_t SMALL_SORT_THRESHOLD = 32;
+
+// Widest k-way merge per pass: beyond this the run heads stop fitting in L1/TLB
+constexpr size_t MAX_MERGE_FAN_IN = 256;
+
+// Output slices per pool worker in a merge pass, to even out the load
+constexpr size_t MERGE_SLICES_PER_WORKER = 4;
+
+// Pool sorts can only hand out per-worker arenas of a context made for their pool
+SortContext *contextFor(SortContext *ctx, const ThreadPool &pool) {
+    return ctx && ctx->serves(pool) ? ctx : nullptr;
+}
+
+// Fan-in that finishes `runs` runs in the fewest passes with even group sizes
+size_t mergeFanIn(size_t runs) {
+    size_t passes = 1;
+    for (size_t reach = MAX_MERGE_FAN_IN; reach < runs; reach *= MAX_MERGE_FAN_IN) {
+        passes++;
+    }
+    size_t fan_in = static_cast<size_t>(std::ceil(std::pow(static_cast<double>(runs), 1.0 / passes)));
+    return std::clamp<size_t>(fan_in, 2, MAX_MERGE_FAN_IN);
+}
+
+// Merge slice [rank_begin, rank_end) of the runs src[bounds[first]..bounds[last]),
+// passing its elements to emit(i, key) in order
+template<class T, class Emit>
+void mergeRunSliceEach(const T *src, std::span<const size_t> bounds, size_t first, size_t last,
+                       size_t rank_begin, size_t rank_end, SortContext *ctx, Emit emit) {
+    ScratchScope scope(ctx);
+    size_t k = last - first;
+    std::pmr::vector<MergeSource<T>> runs(scope.resource());
+    runs.reserve(k);
+    for (size_t r = first; r < last; r++) {
+        runs.push_back({src + bounds[r], src + bounds[r + 1]});
+    }
+
+    std::pmr::vector<size_t> begin_splits(k, scope.resource());
+    std::pmr::vector<size_t> end_splits(k, scope.resource());
+    multiSequenceSelect<T>(runs, rank_begin, begin_splits);
+    multiSequenceSelect<T>(runs, rank_end, end_splits);
+    std::pmr::vector<MergeSource<T>> slice(k, scope.resource());
+    for (size_t r = 0; r < k; r++) {
+        slice[r] = {runs[r].begin + begin_splits[r], runs[r].begin + end_splits[r]};
+    }
+
+    LoserTree<T> tree(slice, scope.resource());
+    tree.mergeEach(rank_end - rank_begin, emit);
+}
+
+// Merge the runs src[bounds[first]..bounds[last]) into the same range of dst,
+// slice [rank_begin, rank_end) of the merged output only
+template<class T>
+void mergeRunSlice(const T *src, T *dst, std::span<const size_t> bounds, size_t first, size_t last,
+                   size_t rank_begin, size_t rank_end, SortContext *ctx) {
+    T *out = dst + bounds[first] + rank_begin;
+    mergeRunSliceEach<T>(src, bounds, first, last, rank_begin, rank_end, ctx, [out](size_t i, T key) {
+        out[i] = key;
+    });
+}
+
+// Merge the sorted runs [data, data + mid) and [data + mid, data + n) in place,
+// staging only the left run in scratch (which must hold mid elements)
+template<class T>
+void mergeAdjacent(T *data, size_t mid, size_t n, T *scratch) {
+    if (mid == 0 || mid == n || !(data[mid] < data[mid - 1])) return;
+    std::copy(data, data + mid, scratch);
+    std::merge(scratch, scratch + mid, data + mid, data + n, data);
+}
+
+// Top-down merge sort of data[0, n) using scratch[0, n / 2)
+template<class T>
+void mergeSortRange(T *data, size_t n, T *scratch) {
+    if (n <= SMALL_SORT_THRESHOLD) {
+        for (size_t i = 1; i < n; i++) {
+            T key = data[i];
+            size_t j = i;
+            for (; j > 0 && key < data[j - 1]; j--) {
+                data[j] = data[j - 1];
+            }
+            data[j] = key;
+        }
         return;
     }
-    size_t chunk_size = (arr.size() + num_chunks - 1) / num_chunks;
 
-    // --- 1. Parallel Sort (Unchanged) ---
-    std::vector<std::future<void>> futures;
-    futures.reserve(num_chunks);
-    for (size_t i = 0; i < num_chunks; ++i) {
-        size_t start = i * chunk_size;
-        size_t end = std::min(start + chunk_size - 1, arr.size() - 1);
-        if (start <= end) {
-            futures.push_back(pool.submit([&arr, start, end]() {
-                mergeSortHelper(arr, start, end);
+    size_t mid = n / 2;
+    mergeSortRange(data, mid, scratch);
+    mergeSortRange(data + mid, n - mid, scratch);
+    mergeAdjacent(data, mid, n, scratch);
+}
+
+// Merge the sorted runs base[bounds[i], bounds[i + 1]) until at most
+// max_runs are left, ping-ponging between base and tmp (which must be as long
+// as base). A loser tree merges up to MAX_MERGE_FAN_IN runs per pass, so even
+// 100M elements take two passes instead of one per doubling of the run
+// length. Each group's output is cut into slices by multi-sequence selection
+// and every slice is merged by its own task. Leaves the remaining runs in
+// `bounds` and returns the buffer that holds them.
+template<class T>
+T *mergeRunsDownTo(T *base, T *tmp, std::pmr::vector<size_t> &bounds, size_t max_runs, ThreadPool &pool,
+                   SortContext *ctx) {
+    ScratchScope scope(ctx);
+    std::pmr::vector<size_t> next_bounds(scope.resource());
+    size_t n = bounds.back();
+    std::pmr::vector<std::future<void>> futures(scope.resource());
+    T *src = base;
+    T *dst = tmp;
+    size_t target_slices = std::max<size_t>(1, pool.size()) * MERGE_SLICES_PER_WORKER;
+    while (bounds.size() - 1 > max_runs) {
+        size_t runs = bounds.size() - 1;
+        size_t fan_in = mergeFanIn(runs);
+        size_t groups = (runs + fan_in - 1) / fan_in;
+        size_t slices_per_group = (target_slices + groups - 1) / groups;
+
+        futures.clear();
+        next_bounds.clear();
+        for (size_t first = 0; first < runs; first += fan_in) {
+            size_t last = std::min(runs, first + fan_in);
+            size_t length = bounds[last] - bounds[first];
+            size_t slices = std::clamp<size_t>(length / MIN_CHUNK_SIZE, 1, slices_per_group);
+            next_bounds.push_back(bounds[first]);
+
+            for (size_t s = 0; s < slices; s++) {
+                size_t rank_begin = length * s / slices;
+                size_t rank_end = length * (s + 1) / slices;
+                futures.push_back(pool.submit([src, dst, &bounds, first, last, rank_begin, rank_end, ctx]() {
+                    mergeRunSlice<T>(src, dst, bounds, first, last, rank_begin, rank_end, ctx);
+                }));
+            }
+        }
+        next_bounds.push_back(n);
+        for (auto &fut : futures) {
+            fut.get();
+        }
+
+        bounds.swap(next_bounds);
+        std::swap(src, dst);
+    }
+    return src;
+}
+
+// Merge the sorted runs base[bounds[i], bounds[i + 1]) into one, in base
+template<class T>
+void mergeSortedRuns(T *base, T *tmp, std::span<const size_t> run_bounds, ThreadPool &pool, SortContext *ctx) {
+    ScratchScope scope(ctx);
+    std::pmr::vector<size_t> bounds(run_bounds.begin(), run_bounds.end(), scope.resource());
+    size_t n = bounds.back();
+    T *src = mergeRunsDownTo(base, tmp, bounds, 1, pool, ctx);
+
+    // An odd number of passes leaves the result in scratch
+    if (src != base) {
+        std::pmr::vector<std::future<void>> futures(scope.resource());
+        size_t target_slices = std::max<size_t>(1, pool.size()) * MERGE_SLICES_PER_WORKER;
+        size_t slice = (n + target_slices - 1) / target_slices;
+        for (size_t start = 0; start < n; start += slice) {
+            size_t length = std::min(slice, n - start);
+            futures.push_back(pool.submit([src, base, start, length]() {
+                std::copy(src + start, src + start + length, base + start);
             }));
         }
+        for (auto &fut : futures) {
+            fut.get();
+        }
+    }
+}
+
+template<class T>
+void mergeSortThreadPoolImpl(std::span<T> data, ThreadPool &pool, SortContext *ctx) {
+    size_t n = data.size();
+    if (n <= 1) return;
+
+    // One scratch buffer for the whole sort; every task stages into its own slice
+    ctx = contextFor(ctx, pool);
+    ScratchScope scope(ctx);
+    std::pmr::vector<T> scratch(n, scope.resource());
+    T *base = data.data();
+    T *tmp = scratch.data();
+
+    size_t num_chunks = (n + MIN_CHUNK_SIZE - 1) / MIN_CHUNK_SIZE;
+    if (num_chunks <= 1) {
+        mergeSortRange(base, n, tmp);
+        return;
+    }
+    size_t chunk_size = (n + num_chunks - 1) / num_chunks;
+
+    // --- 1. Sort every chunk in parallel ---
+    std::pmr::vector<std::future<void>> futures(scope.resource());
+    futures.reserve(num_chunks);
+    for (size_t start = 0; start < n; start += chunk_size) {
+        size_t length = std::min(chunk_size, n - start);
+        futures.push_back(pool.submit([base, tmp, start, length]() {
+            mergeSortRange(base + start, length, tmp + start);
+        }));
     }
     for (auto &fut : futures) {
-        fut.get(); // Wait for all initial sorts
+        fut.get();
+    }
+
+    // --- 2. k-way merge the runs ---
+    std::pmr::vector<size_t> bounds(scope.resource());
+    bounds.reserve(num_chunks + 1);
+    for (size_t start = 0; start < n; start += chunk_size) {
+        bounds.push_back(start);
+    }
+    bounds.push_back(n);
+    mergeSortedRuns<T>(base, tmp, bounds, pool, ctx);
+}
+
+} // namespace
+
+void mergeSortThreadPool(std::vector<int> &arr, ThreadPool &pool, SortContext *ctx) {
+    mergeSortThreadPoolImpl(std::span<int>(arr), pool, ctx);
+}
+
+void mergeSortThreadPool(std::span<int> data, ThreadPool &pool, SortContext *ctx) {
+    mergeSortThreadPoolImpl(data, pool, ctx);
+}
+
+void mergeSortThreadPool(std::span<int64_t> data, ThreadPool &pool, SortContext *ctx) {
+    mergeSortThreadPoolImpl(data, pool, ctx);
+}
+
+// ============================================
+// Adaptive natural merge sort (powersort)
+// ============================================
+
+namespace {
+
+// Galloping starts after this many consecutive wins by one run
+constexpr size_t MIN_GALLOP = 7;
+
+// Chunks smaller than this are not worth a task in the parallel version
+constexpr size_t MIN_NATURAL_CHUNK = 1 << 15;
+
+// Length of the run starting at data[begin]; a strictly descending run is
+// reversed in place (strictly, so equal elements never swap and the sort stays stable)
+size_t makeAscendingRun(int *data, size_t begin, size_t end) {
+    size_t i = begin + 1;
+    if (i == end) return 1;
+    if (data[i] < data[begin]) {
+        while (i + 1 < end && data[i + 1] < data[i]) i++;
+        std::reverse(data + begin, data + i + 1);
+    } else {
+        while (i + 1 < end && !(data[i + 1] < data[i])) i++;
+    }
+    return i + 1 - begin;
+}
+
+// Insert data[sorted_end, end) into the sorted data[begin, sorted_end), finding each slot by binary search
+void binaryInsertionSort(int *data, size_t begin, size_t sorted_end, size_t end) {
+    for (size_t i = sorted_end; i < end; i++) {
+        int key = data[i];
+        int *slot = std::upper_bound(data + begin, data + i, key);
+        std::move_backward(slot, data + i, data + i + 1);
+        *slot = key;
+    }
+}
+
+// Shortest run worth merging: n scaled into [16, 32] so n / min_run is close to a power of two
+size_t minRunLength(size_t n) {
+    size_t low_bits = 0;
+    while (n >= 32) {
+        low_bits |= n & 1;
+        n >>= 1;
+    }
+    return n + low_bits;
+}
+
+// Powersort's merge-tree depth of the boundary between runs [a, b) and [b, c) within [0, n)
+unsigned nodePower(size_t a, size_t b, size_t c, size_t n) {
+    uint64_t two_n = 2 * static_cast<uint64_t>(n);
+    uint64_t left = a + b;
+    uint64_t right = b + c;
+    unsigned power = 0;
+    while (true) {
+        power++;
+        if (left >= two_n) {
+            left -= two_n;
+            right -= two_n;
+        } else if (right >= two_n) {
+            break;
+        }
+        left <<= 1;
+        right <<= 1;
+    }
+    return power;
+}
+
+// Merge the adjacent sorted runs data[0, mid) and data[mid, n). The part of
+// the left run already below the right run and the part of the right run
+// already above the left run are skipped by galloping; the rest is merged
+// through scratch, switching to galloping whenever one side keeps winning.
+void gallopingMerge(int *data, size_t mid, size_t n, std::pmr::vector<int> &scratch) {
+    int *a_begin = std::upper_bound(data, data + mid, data[mid]);
+    const int *b_end = std::lower_bound(data + mid, data + n, data[mid - 1]);
+    if (a_begin == data + mid || b_end == data + mid) return;
+
+    scratch.assign(a_begin, data + mid);
+    const int *a = scratch.data();
+    const int *a_end = a + scratch.size();
+    const int *b = data + mid;
+    int *out = a_begin;
+
+    size_t min_gallop = MIN_GALLOP;
+    while (a < a_end && b < b_end) {
+        // One element at a time until one run wins min_gallop times in a row
+        size_t a_wins = 0, b_wins = 0;
+        while (a < a_end && b < b_end && a_wins < min_gallop && b_wins < min_gallop) {
+            if (*b < *a) {
+                *out++ = *b++;
+                b_wins++;
+                a_wins = 0;
+            } else {
+                *out++ = *a++;
+                a_wins++;
+                b_wins = 0;
+            }
+        }
+
+        // Galloping: copy whole blocks found by binary search while they stay long
+        while (a < a_end && b < b_end) {
+            const int *a_stop = std::upper_bound(a, a_end, *b);
+            size_t a_count = a_stop - a;
+            out = std::copy(a, a_stop, out);
+            a = a_stop;
+            if (a == a_end) break;
+
+            const int *b_stop = std::lower_bound(b, b_end, *a);
+            size_t b_count = b_stop - b;
+            out = std::copy(b, b_stop, out);
+            b = b_stop;
+
+            if (a_count < MIN_GALLOP && b_count < MIN_GALLOP) {
+                min_gallop++;
+                break;
+            }
+            min_gallop = std::max<size_t>(1, min_gallop - 1);
+        }
+    }
+
+    // Whatever is left of the right run is already in place
+    std::copy(a, a_end, out);
+}
+
+// Powersort of data[0, n): natural runs extended to the minimum run length,
+// merged in the order given by their node powers
+void naturalMergeSortRange(int *data, size_t n, std::pmr::vector<int> &scratch) {
+    if (n <= 1) return;
+
+    struct Run {
+        size_t begin;
+        size_t end;
+        unsigned power;
+    };
+    std::pmr::vector<Run> stack(scratch.get_allocator().resource());
+    size_t min_run = minRunLength(n);
+
+    auto next_run = [&](size_t begin) {
+        size_t end = begin + makeAscendingRun(data, begin, n);
+        if (end - begin < min_run) {
+            size_t forced_end = std::min(n, begin + min_run);
+            binaryInsertionSort(data, begin, end, forced_end);
+            end = forced_end;
+        }
+        return end;
+    };
+
+    Run current{0, next_run(0), 0};
+    while (current.end < n) {
+        Run next{current.end, next_run(current.end), 0};
+        unsigned power = nodePower(current.begin, next.begin, next.end, n);
+        while (!stack.empty() && stack.back().power > power) {
+            Run top = stack.back();
+            gallopingMerge(data + top.begin, top.end - top.begin, current.end - top.begin, scratch);
+            current.begin = top.begin;
+            stack.pop_back();
+        }
+        current.power = power;
+        stack.push_back(current);
+        current = next;
+    }
+    while (!stack.empty()) {
+        Run top = stack.back();
+        gallopingMerge(data + top.begin, top.end - top.begin, current.end - top.begin, scratch);
+        current.begin = top.begin;
+        stack.pop_back();
+    }
+}
+
+} // namespace
+
+void naturalMergeSort(std::vector<int> &arr, SortContext *ctx) {
+    ScratchScope scope(ctx);
+    std::pmr::vector<int> scratch(scope.resource());
+    naturalMergeSortRange(arr.data(), arr.size(), scratch);
+}
+
+void naturalMergeSortParallel(std::vector<int> &arr, ThreadPool &pool, SortContext *ctx) {
+    size_t n = arr.size();
+    size_t chunks = std::clamp<size_t>(n / MIN_NATURAL_CHUNK, 1, std::max<size_t>(1, pool.size()));
+    if (chunks <= 1) {
+        naturalMergeSort(arr, ctx);
+        return;
+    }
+
+    // Every chunk finds and merges its own runs
+    ctx = contextFor(ctx, pool);
+    ScratchScope scope(ctx);
+    size_t chunk_size = (n + chunks - 1) / chunks;
+    int *data = arr.data();
+    std::pmr::vector<std::future<void>> futures(scope.resource());
+    std::pmr::vector<size_t> bounds(scope.resource());
+    for (size_t start = 0; start < n; start += chunk_size) {
+        size_t length = std::min(chunk_size, n - start);
+        bounds.push_back(start);
+        futures.push_back(pool.submit([data, start, length, ctx]() {
+            ScratchScope task_scope(ctx);
+            std::pmr::vector<int> scratch(task_scope.resource());
+            naturalMergeSortRange(data + start, length, scratch);
+        }));
+    }
+    bounds.push_back(n);
+    for (auto &fut: futures) {
+        fut.get();
+    }
+
+    // Chunks that already continue their left neighbour form one run, so
+    // presorted input finishes here in O(n)
+    std::pmr::vector<size_t> runs(1, 0, scope.resource());
+    for (size_t i = 1; i + 1 < bounds.size(); i++) {
+        if (data[bounds[i]] < data[bounds[i] - 1]) {
+            runs.push_back(bounds[i]);
+        }
+    }
+    runs.push_back(n);
+    if (runs.size() <= 2) return;
+
+    std::pmr::vector<int> scratch(n, scope.resource());
+    mergeSortedRuns<int>(data, scratch.data(), runs, pool, ctx);
+}
+
+// ============================================
+// In-place merge sort (SymMerge)
+// ============================================
+
+namespace {
+
+// Blocks of this many elements are insertion sorted before merging starts
+constexpr size_t INPLACE_BLOCK = 32;
+
+// Merges shorter than this are not split further for the pool
+constexpr size_t MIN_INPLACE_SPLIT = 1 << 14;
+
+// Bounds of one pending merge of the sorted runs data[a, m) and data[m, b)
+struct MergeJob {
+    size_t a;
+    size_t m;
+    size_t b;
+
+    bool pending() const { return a < m && m < b; }
+};
+
+// One SymMerge step: find the split that makes data[a, start) + data[m, end)
+// the first mid - a elements of the merge and rotate them together. That
+// leaves two independent merges, [a, start) with [start, mid) and [mid, end)
+// with [end, b), each at most half as long.
+std::array<MergeJob, 2> symSplit(int *data, const MergeJob &job) {
+    size_t mid = job.a + (job.b - job.a) / 2;
+    size_t n = mid + job.m;
+    size_t start = job.m > mid ? n - job.b : job.a;
+    size_t limit = job.m > mid ? mid : job.m;
+    while (start < limit) {
+        size_t c = start + (limit - start) / 2;
+        if (!(data[n - 1 - c] < data[c])) {
+            start = c + 1;
+        } else {
+            limit = c;
+        }
+    }
+    size_t end = n - start;
+    if (start < job.m && job.m < end) {
+        std::rotate(data + start, data + job.m, data + end);
+    }
+    return {MergeJob{job.a, start, mid}, MergeJob{mid, end, job.b}};
+}
+
+// Stable merge of data[a, m) and data[m, b) with no buffer: O(n log n) moves
+// and a recursion depth of log2(b - a)
+void symMerge(int *data, const MergeJob &job) {
+    if (!job.pending() || !(data[job.m] < data[job.m - 1])) return;
+
+    // A single element just moves to its slot, before equal keys from the right
+    // run or after equal keys from the left one
+    if (job.m - job.a == 1) {
+        int *slot = std::lower_bound(data + job.m, data + job.b, data[job.a]);
+        std::rotate(data + job.a, data + job.m, slot);
+        return;
+    }
+    if (job.b - job.m == 1) {
+        int *slot = std::upper_bound(data + job.a, data + job.m, data[job.m]);
+        std::rotate(slot, data + job.m, data + job.b);
+        return;
+    }
+
+    auto halves = symSplit(data, job);
+    symMerge(data, halves[0]);
+    symMerge(data, halves[1]);
+}
+
+void insertionSort(int *data, size_t n) {
+    for (size_t i = 1; i < n; i++) {
+        int key = data[i];
+        size_t j = i;
+        while (j > 0 && data[j - 1] > key) {
+            data[j] = data[j - 1];
+            j--;
+        }
+        data[j] = key;
+    }
+}
+
+// Insertion sort INPLACE_BLOCK-sized blocks, then SymMerge them bottom-up
+void inPlaceSortRange(int *data, size_t n) {
+    for (size_t start = 0; start < n; start += INPLACE_BLOCK) {
+        insertionSort(data + start, std::min(INPLACE_BLOCK, n - start));
+    }
+    for (size_t width = INPLACE_BLOCK; width < n; width *= 2) {
+        for (size_t a = 0; a + width < n; a += 2 * width) {
+            symMerge(data, {a, a + width, std::min(n, a + 2 * width)});
+        }
     }
+}
+
+} // namespace
+
+void inPlaceMergeSort(std::vector<int> &arr) {
+    inPlaceSortRange(arr.data(), arr.size());
+}
 
-    // --- 2. Parallel Merge (Updated) ---
-    size_t current_chunk_size = chunk_size;
-    while (current_chunk_size < arr.size()) {
+void inPlaceMergeSortParallel(std::vector<int> &arr, ThreadPool &pool, SortContext *ctx) {
+    size_t n = arr.size();
+    size_t workers = std::max<size_t>(1, pool.size());
+    size_t chunks = std::clamp<size_t>(n / MIN_INPLACE_SPLIT, 1, workers * MERGE_SLICES_PER_WORKER);
+    if (chunks <= 1) {
+        inPlaceMergeSort(arr);
+        return;
+    }
 
-        futures.clear(); // Re-use the futures vector
+    // --- 1. Sort every chunk in place in parallel ---
+    int *data = arr.data();
+    size_t chunk_size = (n + chunks - 1) / chunks;
+    ScratchScope scope(ctx);
+    std::pmr::vector<std::future<void>> futures(scope.resource());
+    for (size_t start = 0; start < n; start += chunk_size) {
+        size_t length = std::min(chunk_size, n - start);
+        futures.push_back(pool.submit([data, start, length]() {
+            inPlaceSortRange(data + start, length);
+        }));
+    }
+    for (auto &fut: futures) {
+        fut.get();
+    }
 
-        for (size_t i = 0; i < arr.size(); i += 2 * current_chunk_size) {
-            size_t left = i;
-            size_t mid = std::min(i + current_chunk_size - 1, arr.size() - 1);
-            size_t right = std::min(i + 2 * current_chunk_size - 1, arr.size() - 1);
+    // --- 2. Merge pairs of runs level by level ---
+    // SymMerge splits a merge into two independent halves, so levels with
+    // fewer pairs than workers are split (one task per job) until every
+    // worker has a few jobs
+    size_t target_jobs = workers * MERGE_SLICES_PER_WORKER;
+    std::pmr::vector<MergeJob> jobs(scope.resource());
+    std::pmr::vector<MergeJob> halves(scope.resource());
+    for (size_t width = chunk_size; width < n; width *= 2) {
+        jobs.clear();
+        for (size_t a = 0; a + width < n; a += 2 * width) {
+            jobs.push_back({a, a + width, std::min(n, a + 2 * width)});
+        }
 
-            if (mid < right) {
-                // Submit the merge task to the pool
-                futures.push_back(pool.submit([&arr, left, mid, right]() {
-                    merge(arr, left, mid, right);
+        while (jobs.size() < target_jobs) {
+            halves.assign(2 * jobs.size(), MergeJob{0, 0, 0});
+            futures.clear();
+            for (size_t j = 0; j < jobs.size(); j++) {
+                if (jobs[j].b - jobs[j].a < 2 * MIN_INPLACE_SPLIT) {
+                    halves[2 * j] = jobs[j];
+                    continue;
+                }
+                futures.push_back(pool.submit([data, &jobs, &halves, j]() {
+                    auto split = symSplit(data, jobs[j]);
+                    halves[2 * j] = split[0];
+                    halves[2 * j + 1] = split[1];
                 }));
             }
+            for (auto &fut: futures) {
+                fut.get();
+            }
+            if (futures.empty()) break;
+
+            jobs.clear();
+            std::copy_if(halves.begin(), halves.end(), std::back_inserter(jobs),
+                         [](const MergeJob &job) { return job.pending(); });
         }
 
-        for (auto &fut : futures) {
+        futures.clear();
+        for (const MergeJob &job: jobs) {
+            futures.push_back(pool.submit([data, job]() { symMerge(data, job); }));
+        }
+        for (auto &fut: futures) {
             fut.get();
         }
+    }
+}
+
+// ============================================
+// Dual-pivot quick sort
+// ============================================
+
+namespace {
+
+// Ranges this short are finished by insertion sort
+constexpr size_t DUAL_PIVOT_INSERTION = 32;
+
+// Sort the five elements at these positions among themselves
+void sortSamples(int *data, const std::array<size_t, 5> &positions) {
+    for (size_t i = 1; i < positions.size(); i++) {
+        for (size_t j = i; j > 0 && data[positions[j]] < data[positions[j - 1]]; j--) {
+            std::swap(data[positions[j]], data[positions[j - 1]]);
+        }
+    }
+}
+
+// Yaroslavskiy's dual-pivot quick sort of data[0, n). The pivots are the
+// second and fourth of five evenly spaced samples, and one scan splits the
+// range into < p1, [p1, p2] and > p2. Equal pivots usually mean heavy
+// duplication, so that case splits into < p, == p and > p instead, and the
+// middle part is never visited again. Recurses into the two lower parts and
+// loops on the upper one. Past `depth` levels it falls back to heap sort.
+void dualPivotSortRange(int *data, size_t n, unsigned depth) {
+    while (n > DUAL_PIVOT_INSERTION) {
+        if (depth-- == 0) {
+            heapSortRange<size_t>(data, n);
+            return;
+        }
+
+        size_t step = n / 6;
+        std::array<size_t, 5> samples = {step, 2 * step, 3 * step, 4 * step, 5 * step};
+        sortSamples(data, samples);
+        int p1 = data[samples[1]];
+        int p2 = data[samples[3]];
+
+        if (p1 == p2) {
+            size_t less = 0, k = 0, greater = n;
+            while (k < greater) {
+                if (data[k] < p1) {
+                    std::swap(data[less++], data[k++]);
+                } else if (data[k] > p1) {
+                    std::swap(data[k], data[--greater]);
+                } else {
+                    k++;
+                }
+            }
+            dualPivotSortRange(data, less, depth);
+            data += greater;
+            n -= greater;
+            continue;
+        }
+
+        // Pivots to the ends; data[1, less) < p1 and data(greater, n - 1) > p2 as the scan goes
+        std::swap(data[samples[1]], data[0]);
+        std::swap(data[samples[3]], data[n - 1]);
+        size_t less = 1;
+        size_t greater = n - 2;
+        for (size_t k = less; k <= greater; k++) {
+            if (data[k] < p1) {
+                std::swap(data[k], data[less++]);
+            } else if (data[k] > p2) {
+                while (data[greater] > p2 && k < greater) {
+                    greater--;
+                }
+                std::swap(data[k], data[greater--]);
+                if (data[k] < p1) {
+                    std::swap(data[k], data[less++]);
+                }
+            }
+        }
+        std::swap(data[0], data[less - 1]);
+        std::swap(data[n - 1], data[greater + 1]);
 
-        current_chunk_size *= 2; // Move to the next pass
+        // data[less - 1] == p1 and data[greater + 1] == p2 are in place
+        dualPivotSortRange(data, less - 1, depth);
+        dualPivotSortRange(data + less, greater + 1 - less, depth);
+        data += greater + 2;
+        n -= greater + 2;
     }
+    insertionSort(data, n);
+}
+
+} // namespace
+
+void dualPivotQuickSort(std::vector<int> &arr) {
+    size_t n = arr.size();
+    if (n < 2) return;
+    dualPivotSortRange(arr.data(), n, 2 * static_cast<unsigned>(std::bit_width(n)));
 }
 
 // ============================================
-// Verification function
+// Bitonic sort
 // ============================================
 
-bool isSorted(const std::vector<int> &arr) {
-    for (size_t i = 1; i < arr.size(); i++) {
-        if (arr[i] < arr[i - 1]) {
-            return false;
+namespace {
+
+// Smallest share of the network's width per task in the pool version
+constexpr size_t MIN_BITONIC_CHUNK = 1 << 14;
+
+// Compare-exchange pairs [first, last) of step (k, j) of the bitonic network
+// over a power-of-two width: in merges of width k, the first step (j == k / 2)
+// pairs i with its mirror in the block, later steps pair i with i + j. Every
+// pair puts the smaller key first, so positions past n act as +infinity and
+// their pairs are skipped, which sorts any n. Pair indices map to contiguous
+// runs of positions, and the min/max bodies have no branches, so the runs
+// vectorize.
+void bitonicStep(int *data, size_t n, size_t k, size_t j, size_t first, size_t last) {
+    bool mirror = j == k / 2;
+    for (size_t p = first; p < last;) {
+        size_t offset = p % j;
+        size_t run = std::min(j - offset, last - p);
+        size_t low = p / j * 2 * j + offset;
+        if (low >= n) break;
+        p += run;
+
+        if (mirror) {
+            // Partner of low + t is high - t; skip the t whose partner is past n
+            size_t high = low - offset + 2 * j - 1 - offset;
+            size_t skip = high >= n ? high - n + 1 : 0;
+            if (skip >= run) continue;
+            int *a = data + low;
+            int *b = data + high;
+            for (size_t t = skip; t < run; t++) {
+                int x = a[t];
+                int y = *(b - t);
+                int low_key = std::min(x, y);
+                int high_key = std::max(x, y);
+                a[t] = low_key;
+                *(b - t) = high_key;
+            }
+        } else {
+            size_t high = low + j;
+            if (high >= n) continue;
+            run = std::min(run, n - high);
+            int *a = data + low;
+            int *b = data + high;
+            for (size_t t = 0; t < run; t++) {
+                int x = a[t];
+                int y = b[t];
+                int low_key = std::min(x, y);
+                int high_key = std::max(x, y);
+                a[t] = low_key;
+                b[t] = high_key;
+            }
         }
     }
-    return true;
-}
\ No newline at end of file
+}
+
+} // namespace
+
+void bitonicSort(std::vector<int> &arr) {
+    size_t n = arr.size();
+    if (n < 2) return;
+
+    size_t width = std::bit_ceil(n);
+    for (size_t k = 2; k <= width; k *= 2) {
+        for (size_t j = k / 2; j > 0; j /= 2) {
+            bitonicStep(arr.data(), n, k, j, 0, width / 2);
+        }
+    }
+}
+
+void bitonicSortParallel(std::vector<int> &arr, ThreadPool &pool) {
+    size_t n = arr.size();
+    if (n < 2) return;
+
+    // The calling thread runs one task of every phase and waits for the rest,
+    // so a pool worker calling in sorts alone
+    size_t width = std::bit_ceil(n);
+    size_t tasks = std::min(std::bit_floor(pool.size() + 1), std::max<size_t>(1, width / MIN_BITONIC_CHUNK));
+    if (pool.currentWorkerIndex() != ThreadPool::NOT_A_WORKER) {
+        tasks = 1;
+    }
+    if (tasks == 1) {
+        bitonicSort(arr);
+        return;
+    }
+
+    // Each task owns an equal slice of every step's pairs. Steps that pair
+    // within blocks no wider than a task's chunk touch only that chunk, so
+    // runs of them form one phase; a step that crosses chunks is a phase of
+    // its own. Phases are fanned out and joined one after another.
+    size_t chunk = width / tasks;
+    size_t pairs = width / 2 / tasks;
+    auto local = [chunk](size_t j) { return 2 * j <= chunk; };
+    std::vector<std::pair<size_t, size_t>> steps;
+    for (size_t k = 2; k <= width; k *= 2) {
+        for (size_t j = k / 2; j > 0; j /= 2) {
+            steps.emplace_back(k, j);
+        }
+    }
+
+    int *data = arr.data();
+    std::vector<std::future<void>> futures;
+    futures.reserve(tasks - 1);
+    for (size_t begin = 0; begin < steps.size();) {
+        size_t end = begin + 1;
+        while (end < steps.size() && local(steps[end - 1].second) && local(steps[end].second)) {
+            end++;
+        }
+        auto run = [data, n, pairs, &steps, begin, end](size_t task) {
+            for (size_t s = begin; s < end; s++) {
+                bitonicStep(data, n, steps[s].first, steps[s].second, task * pairs, (task + 1) * pairs);
+            }
+        };
+        futures.clear();
+        for (size_t task = 1; task < tasks; task++) {
+            futures.push_back(pool.submit(run, task));
+        }
+        run(0);
+        for (auto &fut: futures) {
+            fut.get();
+        }
+        begin = end;
+    }
+}
+
+// ============================================
+// Segmented sort
+// ============================================
+
+namespace {
+
+// Optimal sorting networks for 2..8 elements, as (i, j) compare-exchange pairs
+struct NetworkPair {
+    unsigned char i, j;
+};
+
+constexpr NetworkPair NETWORK_2[] = {{0, 1}};
+constexpr NetworkPair NETWORK_3[] = {{0, 2}, {0, 1}, {1, 2}};
+constexpr NetworkPair NETWORK_4[] = {{0, 2}, {1, 3}, {0, 1}, {2, 3}, {1, 2}};
+constexpr NetworkPair NETWORK_5[] = {
+    {0, 3}, {1, 4}, {0, 2}, {1, 3}, {0, 1}, {2, 4}, {1, 2}, {3, 4}, {2, 3}
+};
+constexpr NetworkPair NETWORK_6[] = {
+    {0, 5}, {1, 3}, {2, 4}, {1, 2}, {3, 4}, {0, 3}, {2, 5}, {0, 1}, {2, 3}, {4, 5}, {1, 2}, {3, 4}
+};
+constexpr NetworkPair NETWORK_7[] = {
+    {0, 6}, {2, 3}, {4, 5}, {0, 2}, {1, 4}, {3, 6}, {0, 1}, {2, 5}, {3, 4},
+    {1, 2}, {4, 6}, {2, 3}, {4, 5}, {1, 2}, {3, 4}, {5, 6}
+};
+constexpr NetworkPair NETWORK_8[] = {
+    {0, 2}, {1, 3}, {4, 6}, {5, 7}, {0, 4}, {1, 5}, {2, 6}, {3, 7}, {0, 1}, {2, 3},
+    {4, 5}, {6, 7}, {2, 4}, {3, 5}, {1, 4}, {3, 6}, {1, 2}, {3, 4}, {5, 6}
+};
+
+template<size_t N>
+inline void applyNetwork(int *data, const NetworkPair (&network)[N]) {
+    for (const auto &pair: network) {
+        // min/max compile to conditional moves: no data-dependent branches
+        int a = data[pair.i];
+        int b = data[pair.j];
+        data[pair.i] = std::min(a, b);
+        data[pair.j] = std::max(a, b);
+    }
+}
+
+// Segments up to this size use insertion sort; larger ones use introsort
+constexpr size_t SEGMENT_INSERTION_LIMIT = 32;
+
+void sortSegment(int *data, size_t n) {
+    switch (n) {
+        case 0:
+        case 1: return;
+        case 2: applyNetwork(data, NETWORK_2); return;
+        case 3: applyNetwork(data, NETWORK_3); return;
+        case 4: applyNetwork(data, NETWORK_4); return;
+        case 5: applyNetwork(data, NETWORK_5); return;
+        case 6: applyNetwork(data, NETWORK_6); return;
+        case 7: applyNetwork(data, NETWORK_7); return;
+        case 8: applyNetwork(data, NETWORK_8); return;
+        default: break;
+    }
+    if (n <= SEGMENT_INSERTION_LIMIT) {
+        insertionSort(data, n);
+    } else {
+        std::sort(data, data + n);
+    }
+}
+
+void sortSegments(std::vector<int> &values, const std::vector<size_t> &offsets, size_t first, size_t last) {
+    for (size_t s = first; s < last; s++) {
+        sortSegment(values.data() + offsets[s], offsets[s + 1] - offsets[s]);
+    }
+}
+
+// Estimated comparison work of sorting n elements
+double segmentCost(size_t n) {
+    return n < 2 ? 1.0 : static_cast<double>(n) * std::log2(static_cast<double>(n));
+}
+
+} // namespace
+
+void segmentedSort(std::vector<int> &values, const std::vector<size_t> &offsets) {
+    if (offsets.size() < 2) return;
+    sortSegments(values, offsets, 0, offsets.size() - 1);
+}
+
+void segmentedSort(std::vector<int> &values, const std::vector<size_t> &offsets, ThreadPool &pool,
+                   SortContext *ctx) {
+    if (offsets.size() < 2) return;
+    size_t segment_count = offsets.size() - 1;
+
+    // Prefix sums of estimated work, so each task gets an equal share of the
+    // work rather than an equal number of segments
+    ScratchScope scope(ctx);
+    std::pmr::vector<double> prefix(segment_count + 1, 0.0, scope.resource());
+    for (size_t s = 0; s < segment_count; s++) {
+        prefix[s + 1] = prefix[s] + segmentCost(offsets[s + 1] - offsets[s]);
+    }
+
+    // A few tasks per worker smooths out uneven segment costs
+    constexpr double MIN_TASK_COST = 1 << 16;
+    size_t task_count = std::max<size_t>(1, pool.size() * 4);
+    task_count = std::min(task_count, static_cast<size_t>(prefix.back() / MIN_TASK_COST) + 1);
+    if (task_count <= 1) {
+        sortSegments(values, offsets, 0, segment_count);
+        return;
+    }
+
+    std::pmr::vector<std::future<void>> futures(scope.resource());
+    futures.reserve(task_count);
+    size_t first = 0;
+    for (size_t t = 1; t <= task_count && first < segment_count; t++) {
+        double target = prefix.back() * static_cast<double>(t) / static_cast<double>(task_count);
+        size_t last = t == task_count
+                          ? segment_count
+                          : static_cast<size_t>(std::lower_bound(prefix.begin(), prefix.end(), target) - prefix.begin());
+        last = std::clamp(last, first + 1, segment_count);
+
+        futures.push_back(pool.submit([&values, &offsets, first, last]() {
+            sortSegments(values, offsets, first, last);
+        }));
+        first = last;
+    }
+    for (auto &fut: futures) {
+        fut.get();
+    }
+}
+
+// ============================================
+// LSD radix sort
+// ============================================
+
+namespace {
+
+constexpr unsigned RADIX_BITS = 8;
+constexpr size_t RADIX_BUCKETS = size_t(1) << RADIX_BITS;
+
+// Smallest block a parallel radix pass or parallelFor task works on
+constexpr size_t MIN_PARALLEL_BLOCK = 1 << 14;
+
+// Unsigned image of a key whose unsigned order matches the signed order
+inline uint64_t radixImage(int key) { return static_cast<uint32_t>(key) ^ 0x80000000u; }
+
+inline uint64_t radixImage(int64_t key) { return static_cast<uint64_t>(key) ^ (uint64_t(1) << 63); }
+
+// Blocks to split n elements into for a pool (1 without a pool)
+size_t parallelBlocks(size_t n, ThreadPool *pool) {
+    if (!pool) return 1;
+    return std::clamp<size_t>(n / MIN_PARALLEL_BLOCK, 1, std::max<size_t>(1, pool->size()) * 4);
+}
+
+// Run body(block, begin, end) over [0, n) in `blocks` equal blocks, on the pool if there is more than one
+template<class Body>
+void forBlocks(ThreadPool *pool, size_t n, size_t blocks, Body body,
+               std::pmr::memory_resource *resource = std::pmr::new_delete_resource()) {
+    size_t block_size = (n + blocks - 1) / std::max<size_t>(blocks, 1);
+    if (blocks <= 1) {
+        body(0, 0, n);
+        return;
+    }
+    std::pmr::vector<std::future<void>> futures(resource);
+    futures.reserve(blocks);
+    for (size_t b = 0; b < blocks; b++) {
+        size_t begin = std::min(n, b * block_size);
+        size_t end = std::min(n, begin + block_size);
+        futures.push_back(pool->submit([&body, b, begin, end]() { body(b, begin, end); }));
+    }
+    for (auto &fut: futures) {
+        fut.get();
+    }
+}
+
+// Stable LSD radix sort of data[0, n) on bits [low_bit, high_bit) of radixImage,
+// RADIX_BITS per pass, through scratch[0, n). Each block histograms its part,
+// and blocks scatter to offsets laid out digit-major, block-minor, which keeps
+// the sort stable. Passes whose digit is the same for every key are skipped.
+template<class T>
+void lsdRadixSort(T *data, T *scratch, size_t n, unsigned low_bit, unsigned high_bit, ThreadPool *pool,
+                  std::pmr::memory_resource *resource) {
+    if (n <= 1) return;
+
+    size_t blocks = parallelBlocks(n, pool);
+    std::pmr::vector<std::array<size_t, RADIX_BUCKETS>> counts(blocks, resource);
+    T *src = data;
+    T *dst = scratch;
+
+    for (unsigned shift = low_bit; shift < high_bit; shift += RADIX_BITS) {
+        auto digit = [shift](T key) { return (radixImage(key) >> shift) & (RADIX_BUCKETS - 1); };
+
+        forBlocks(pool, n, blocks, [&](size_t b, size_t begin, size_t end) {
+            counts[b].fill(0);
+            for (size_t i = begin; i < end; i++) {
+                counts[b][digit(src[i])]++;
+            }
+        }, resource);
+
+        bool trivial = false;
+        size_t offset = 0;
+        for (size_t d = 0; d < RADIX_BUCKETS; d++) {
+            size_t digit_total = 0;
+            for (size_t b = 0; b < blocks; b++) {
+                size_t count = counts[b][d];
+                counts[b][d] = offset;
+                offset += count;
+                digit_total += count;
+            }
+            trivial = trivial || digit_total == n;
+        }
+        if (trivial) continue;
+
+        forBlocks(pool, n, blocks, [&](size_t b, size_t begin, size_t end) {
+            std::array<size_t, RADIX_BUCKETS> &next = counts[b];
+            for (size_t i = begin; i < end; i++) {
+                dst[next[digit(src[i])]++] = src[i];
+            }
+        }, resource);
+        std::swap(src, dst);
+    }
+
+    if (src != data) {
+        forBlocks(pool, n, blocks, [&](size_t, size_t begin, size_t end) {
+            std::copy(src + begin, src + end, data + begin);
+        }, resource);
+    }
+}
+
+} // namespace
+
+void radixSortLSD(std::vector<int> &arr, SortContext *ctx) {
+    ScratchScope scope(ctx);
+    std::pmr::vector<int> scratch(arr.size(), scope.resource());
+    lsdRadixSort(arr.data(), scratch.data(), arr.size(), 0, 32, nullptr, scope.resource());
+}
+
+void radixSortLSD(std::vector<int> &arr, ThreadPool &pool, SortContext *ctx) {
+    // Only the calling thread allocates here, so any context will do
+    ScratchScope scope(ctx);
+    std::pmr::vector<int> scratch(arr.size(), scope.resource());
+    lsdRadixSort(arr.data(), scratch.data(), arr.size(), 0, 32, &pool, scope.resource());
+}
+
+void parallelFor(ThreadPool &pool, size_t n, const std::function<void(size_t, size_t)> &body) {
+    forBlocks(&pool, n, parallelBlocks(n, &pool), [&body](size_t, size_t begin, size_t end) {
+        body(begin, end);
+    });
+}
+
+// ============================================
+// In-place MSD radix sort (American flag sort)
+// ============================================
+
+namespace {
+
+// Buckets this short are handed to the comparison sort
+constexpr size_t MSD_COMPARISON_THRESHOLD = 128;
+
+// Parallel permutation rounds before the leftovers are placed by one thread
+constexpr int MSD_PARALLEL_ROUNDS = 4;
+
+inline size_t msdDigit(int key, unsigned shift) {
+    return (radixImage(key) >> shift) & (RADIX_BUCKETS - 1);
+}
+
+// Bucket boundaries from digit counts: bucket d is [bounds[d], bounds[d + 1])
+std::array<size_t, RADIX_BUCKETS + 1> bucketBounds(const std::array<size_t, RADIX_BUCKETS> &counts) {
+    std::array<size_t, RADIX_BUCKETS + 1> bounds{};
+    for (size_t d = 0; d < RADIX_BUCKETS; d++) {
+        bounds[d + 1] = bounds[d] + counts[d];
+    }
+    return bounds;
+}
+
+// American flag sort of data[0, n) on the digit at `shift` and below: count
+// the digits, then follow cycles, swapping every key straight into the next
+// free slot of its bucket, and recurse into the buckets. A digit shared by
+// every key costs one counting pass and no moves.
+void americanFlagSort(int *data, size_t n, unsigned shift) {
+    if (n <= MSD_COMPARISON_THRESHOLD) {
+        dualPivotSortRange(data, n, 2 * static_cast<unsigned>(std::bit_width(n)));
+        return;
+    }
+
+    std::array<size_t, RADIX_BUCKETS> counts{};
+    for (size_t i = 0; i < n; i++) {
+        counts[msdDigit(data[i], shift)]++;
+    }
+    if (counts[msdDigit(data[0], shift)] == n) {
+        if (shift > 0) americanFlagSort(data, n, shift - RADIX_BITS);
+        return;
+    }
+
+    std::array<size_t, RADIX_BUCKETS + 1> bounds = bucketBounds(counts);
+    std::array<size_t, RADIX_BUCKETS> heads;
+    std::copy(bounds.begin(), bounds.end() - 1, heads.begin());
+    for (size_t d = 0; d < RADIX_BUCKETS; d++) {
+        while (heads[d] < bounds[d + 1]) {
+            int value = data[heads[d]];
+            size_t digit = msdDigit(value, shift);
+            while (digit != d) {
+                std::swap(value, data[heads[digit]++]);
+                digit = msdDigit(value, shift);
+            }
+            data[heads[d]++] = value;
+        }
+    }
+
+    if (shift == 0) return;
+    for (size_t d = 0; d < RADIX_BUCKETS; d++) {
+        americanFlagSort(data + bounds[d], bounds[d + 1] - bounds[d], shift - RADIX_BITS);
+    }
+}
+
+// Place every key of data[0, n) in its bucket for the digit at `shift`,
+// in place, on the pool (PARADIS-style). Each round splits the unfilled part
+// of every bucket into one stripe per task, and each task runs the cycle
+// walk within its own stripes, leaving keys whose target stripe is full where
+// they are. Then every bucket moves its correct keys to the front of its
+// unfilled part, which shrinks to the misplaced keys, and the next round
+// starts there. A last round with a single stripe always finishes.
+void parallelBucketPermute(int *data, const std::array<size_t, RADIX_BUCKETS + 1> &bounds, unsigned shift,
+                           ThreadPool &pool, std::pmr::memory_resource *resource) {
+    size_t stripes = std::max<size_t>(1, pool.size());
+    std::array<size_t, RADIX_BUCKETS> heads;
+    std::copy(bounds.begin(), bounds.end() - 1, heads.begin());
+    size_t remaining = bounds[RADIX_BUCKETS];
+
+    for (int round = 0; remaining > 0; round++) {
+        size_t tasks = round < MSD_PARALLEL_ROUNDS && remaining >= MIN_PARALLEL_BLOCK ? stripes : 1;
+        forBlocks(&pool, tasks, tasks, [&](size_t stripe, size_t, size_t) {
+            // Stripe `stripe` of every bucket's unfilled part: keys of digit d
+            // fill [begin[d], fill[d]); scan[d] is the next key to look at
+            std::array<size_t, RADIX_BUCKETS> fill, end;
+            for (size_t d = 0; d < RADIX_BUCKETS; d++) {
+                size_t length = bounds[d + 1] - heads[d];
+                fill[d] = heads[d] + length * stripe / tasks;
+                end[d] = heads[d] + length * (stripe + 1) / tasks;
+            }
+            for (size_t d = 0; d < RADIX_BUCKETS; d++) {
+                for (size_t scan = fill[d]; scan < end[d]; scan++) {
+                    int value = data[scan];
+                    size_t digit = msdDigit(value, shift);
+                    while (digit != d && fill[digit] < end[digit]) {
+                        std::swap(value, data[fill[digit]++]);
+                        digit = msdDigit(value, shift);
+                    }
+                    if (digit == d) {
+                        data[scan] = data[fill[d]];
+                        data[fill[d]++] = value;
+                    } else {
+                        data[scan] = value;
+                    }
+                }
+            }
+        }, resource);
+
+        forBlocks(&pool, RADIX_BUCKETS, std::min(RADIX_BUCKETS, stripes), [&](size_t, size_t begin, size_t end) {
+            for (size_t d = begin; d < end; d++) {
+                heads[d] = std::partition(data + heads[d], data + bounds[d + 1], [d, shift](int key) {
+                    return msdDigit(key, shift) == d;
+                }) - data;
+            }
+        }, resource);
+
+        remaining = 0;
+        for (size_t d = 0; d < RADIX_BUCKETS; d++) {
+            remaining += bounds[d + 1] - heads[d];
+        }
+    }
+}
+
+// American flag sort with the counting and the permutation of the top digits
+// on the pool. Buckets of at most n / workers keys are sorted sequentially,
+// one task each; larger ones (skewed keys) recurse with the parallel version.
+void americanFlagSortParallel(int *data, size_t n, unsigned shift, ThreadPool &pool,
+                              std::pmr::memory_resource *resource) {
+    size_t workers = std::max<size_t>(1, pool.size());
+    if (workers == 1 || n < 2 * MIN_PARALLEL_BLOCK) {
+        americanFlagSort(data, n, shift);
+        return;
+    }
+
+    size_t blocks = parallelBlocks(n, &pool);
+    std::pmr::vector<std::array<size_t, RADIX_BUCKETS>> block_counts(blocks, resource);
+    forBlocks(&pool, n, blocks, [&](size_t b, size_t begin, size_t end) {
+        block_counts[b].fill(0);
+        for (size_t i = begin; i < end; i++) {
+            block_counts[b][msdDigit(data[i], shift)]++;
+        }
+    }, resource);
+    std::array<size_t, RADIX_BUCKETS> counts{};
+    for (const auto &block: block_counts) {
+        for (size_t d = 0; d < RADIX_BUCKETS; d++) {
+            counts[d] += block[d];
+        }
+    }
+    if (counts[msdDigit(data[0], shift)] == n) {
+        if (shift > 0) americanFlagSortParallel(data, n, shift - RADIX_BITS, pool, resource);
+        return;
+    }
+
+    std::array<size_t, RADIX_BUCKETS + 1> bounds = bucketBounds(counts);
+    parallelBucketPermute(data, bounds, shift, pool, resource);
+    if (shift == 0) return;
+
+    std::pmr::vector<std::future<void>> futures(resource);
+    for (size_t d = 0; d < RADIX_BUCKETS; d++) {
+        size_t length = bounds[d + 1] - bounds[d];
+        if (length > n / workers) {
+            americanFlagSortParallel(data + bounds[d], length, shift - RADIX_BITS, pool, resource);
+        } else if (length > 1) {
+            futures.push_back(pool.submit([data, &bounds, d, length, shift]() {
+                americanFlagSort(data + bounds[d], length, shift - RADIX_BITS);
+            }));
+        }
+    }
+    for (auto &fut: futures) {
+        fut.get();
+    }
+}
+
+} // namespace
+
+void radixSortMSD(std::vector<int> &arr) {
+    if (arr.size() > 1) {
+        americanFlagSort(arr.data(), arr.size(), 32 - RADIX_BITS);
+    }
+}
+
+void radixSortMSD(std::vector<int> &arr, ThreadPool &pool, SortContext *ctx) {
+    if (arr.size() > 1) {
+        ScratchScope scope(contextFor(ctx, pool));
+        americanFlagSortParallel(arr.data(), arr.size(), 32 - RADIX_BITS, pool, scope.resource());
+    }
+}
+
+// ============================================
+// Key-value sorts and argsort
+// ============================================
+
+namespace {
+
+// (key, low) packed so that signed 64-bit order is key order, then low order
+inline int64_t packKey(int key, uint32_t low) {
+    return static_cast<int64_t>(static_cast<uint64_t>(static_cast<int64_t>(key)) << 32 | low);
+}
+
+inline int unpackKey(int64_t packed) { return static_cast<int>(packed >> 32); }
+
+inline uint32_t unpackLow(int64_t packed) { return static_cast<uint32_t>(packed); }
+
+// Sort packed pairs by key. Radix looks at the key half only (stable by
+// construction); merge sort compares the whole word, which is stable when the
+// low half is the input index.
+void sortPacked(std::span<int64_t> packed, ThreadPool &pool, SortEngine engine, SortContext *ctx) {
+    if (engine == SortEngine::Radix) {
+        ScratchScope scope(ctx);
+        std::pmr::vector<int64_t> scratch(packed.size(), scope.resource());
+        lsdRadixSort(packed.data(), scratch.data(), packed.size(), 32, 64, &pool, scope.resource());
+    } else {
+        mergeSortThreadPool(packed, pool, ctx);
+    }
+}
+
+// Keys packed with their input index
+void packWithIndex(const std::vector<int> &keys, std::span<int64_t> packed, ThreadPool &pool) {
+    parallelFor(pool, keys.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            packed[i] = packKey(keys[i], static_cast<uint32_t>(i));
+        }
+    });
+}
+
+} // namespace
+
+std::vector<uint32_t> argsort(const std::vector<int> &keys, ThreadPool &pool, SortEngine engine, SortContext *ctx) {
+    std::vector<uint32_t> order(keys.size());
+    argsort(keys, order, pool, engine, ctx);
+    return order;
+}
+
+void argsort(const std::vector<int> &keys, std::span<uint32_t> order, ThreadPool &pool, SortEngine engine,
+             SortContext *ctx) {
+    ScratchScope scope(ctx);
+    std::pmr::vector<int64_t> packed(keys.size(), scope.resource());
+    packWithIndex(keys, packed, pool);
+    sortPacked(packed, pool, engine, ctx);
+
+    parallelFor(pool, keys.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            order[i] = unpackLow(packed[i]);
+        }
+    });
+}
+
+void sortByKey(std::vector<int> &keys, std::vector<uint32_t> &values, ThreadPool &pool, SortEngine engine,
+               SortContext *ctx) {
+    // The payload rides in the low half, so no gather is needed afterwards
+    ScratchScope scope(ctx);
+    std::pmr::vector<int64_t> packed(keys.size(), scope.resource());
+    parallelFor(pool, keys.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            packed[i] = packKey(keys[i], values[i]);
+        }
+    });
+    sortPacked(packed, pool, engine, ctx);
+
+    parallelFor(pool, keys.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            keys[i] = unpackKey(packed[i]);
+            values[i] = unpackLow(packed[i]);
+        }
+    });
+}
+
+void stableSortByKey(std::vector<int> &keys, std::vector<uint32_t> &values, ThreadPool &pool, SortEngine engine,
+                     SortContext *ctx) {
+    // Radix reads only the key half, so sorting (key, value) pairs is already
+    // stable; it also needs no 32-bit input index, which caps the gather path
+    if (engine == SortEngine::Radix || keys.size() > UINT32_MAX) {
+        sortByKey(keys, values, pool, SortEngine::Radix, ctx);
+        return;
+    }
+
+    ScratchScope scope(ctx);
+    std::pmr::vector<int64_t> packed(keys.size(), scope.resource());
+    packWithIndex(keys, packed, pool);
+    sortPacked(packed, pool, engine, ctx);
+
+    // Swap each input index for the value it points at, then unpack: the
+    // packed array doubles as the gather buffer
+    parallelFor(pool, keys.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            packed[i] = packKey(unpackKey(packed[i]), values[unpackLow(packed[i])]);
+        }
+    });
+    parallelFor(pool, keys.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            keys[i] = unpackKey(packed[i]);
+            values[i] = unpackLow(packed[i]);
+        }
+    });
+}
+
+// ============================================
+// Fused sort-unique and sort-reduce
+// ============================================
+
+namespace {
+
+// Part of a buffer written by one writer of a compacting pass: [begin, begin + length)
+struct OutputRegion {
+    size_t begin;
+    size_t length;
+};
+
+// Concatenate the regions of src into out, in order. Each region is sorted
+// and holds no two elements with equal keys; an element whose key matches the
+// last one kept (at most the first of a region) is folded into it with
+// combine. Only the region boundaries are visited sequentially, the copies run
+// on the pool. Returns the number of elements written.
+template<class T, class SameKey, class Combine>
+size_t stitchRegions(T *src, std::span<const OutputRegion> regions, T *out, ThreadPool &pool,
+                     std::pmr::memory_resource *resource, SameKey same_key, Combine combine) {
+    std::pmr::vector<size_t> skip(regions.size(), 0, resource);
+    std::pmr::vector<size_t> targets(regions.size(), 0, resource);
+    T *last_kept = nullptr;
+    size_t total = 0;
+    for (size_t r = 0; r < regions.size(); r++) {
+        targets[r] = total;
+        if (regions[r].length == 0) continue;
+        T *head = src + regions[r].begin;
+        if (last_kept && same_key(*last_kept, *head)) {
+            *last_kept = combine(*last_kept, *head);
+            skip[r] = 1;
+        }
+        total += regions[r].length - skip[r];
+        if (regions[r].length > skip[r]) {
+            last_kept = head + regions[r].length - 1;
+        }
+    }
+
+    forBlocks(&pool, regions.size(), parallelBlocks(total, &pool), [&](size_t, size_t begin, size_t end) {
+        for (size_t r = begin; r < end; r++) {
+            const T *region = src + regions[r].begin;
+            std::copy(region + skip[r], region + regions[r].length, out + targets[r]);
+        }
+    }, resource);
+    return total;
+}
+
+// Writer that appends to out, folding a key equal to the last one written into it
+template<class T, class SameKey, class Combine>
+inline void appendFolded(T *out, size_t &written, T key, SameKey &same_key, Combine &combine) {
+    if (written > 0 && same_key(out[written - 1], key)) {
+        out[written - 1] = combine(out[written - 1], key);
+    } else {
+        out[written++] = key;
+    }
+}
+
+// mergeSortThreadPool whose last pass folds equal keys: the usual merge passes
+// stop at MAX_MERGE_FAN_IN runs, and every slice of the final k-way merge
+// compacts its output as it writes it. The slices are then stitched together
+// into the buffer the merge read from, and copied to data if that is scratch.
+template<class T, class SameKey, class Combine>
+size_t mergeSortReduce(T *data, size_t n, ThreadPool &pool, SortContext *ctx, SameKey same_key, Combine combine) {
+    if (n == 0) return 0;
+
+    ctx = contextFor(ctx, pool);
+    ScratchScope scope(ctx);
+    std::pmr::vector<T> scratch(n, scope.resource());
+    T *tmp = scratch.data();
+
+    // --- 1. Sort every chunk in parallel ---
+    size_t num_chunks = (n + MIN_CHUNK_SIZE - 1) / MIN_CHUNK_SIZE;
+    size_t chunk_size = (n + num_chunks - 1) / num_chunks;
+    std::pmr::vector<size_t> bounds(scope.resource());
+    std::pmr::vector<std::future<void>> futures(scope.resource());
+    for (size_t start = 0; start < n; start += chunk_size) {
+        size_t length = std::min(chunk_size, n - start);
+        bounds.push_back(start);
+        futures.push_back(pool.submit([data, tmp, start, length]() {
+            mergeSortRange(data + start, length, tmp + start);
+        }));
+    }
+    bounds.push_back(n);
+    for (auto &fut: futures) {
+        fut.get();
+    }
+
+    // --- 2. Merge down to one loser tree's worth of runs ---
+    T *src = mergeRunsDownTo(data, tmp, bounds, MAX_MERGE_FAN_IN, pool, ctx);
+    T *dst = src == data ? tmp : data;
+
+    // --- 3. Last k-way merge, folding per slice ---
+    size_t runs = bounds.size() - 1;
+    size_t slices = std::clamp<size_t>(n / MIN_CHUNK_SIZE, 1,
+                                       std::max<size_t>(1, pool.size()) * MERGE_SLICES_PER_WORKER);
+    std::pmr::vector<OutputRegion> regions(slices, scope.resource());
+    futures.clear();
+    for (size_t s = 0; s < slices; s++) {
+        size_t rank_begin = n * s / slices;
+        size_t rank_end = n * (s + 1) / slices;
+        futures.push_back(pool.submit([&, s, rank_begin, rank_end]() {
+            T *out = dst + rank_begin;
+            size_t written = 0;
+            mergeRunSliceEach<T>(src, bounds, 0, runs, rank_begin, rank_end, ctx, [&](size_t, T key) {
+                appendFolded(out, written, key, same_key, combine);
+            });
+            regions[s] = {rank_begin, written};
+        }));
+    }
+    for (auto &fut: futures) {
+        fut.get();
+    }
+
+    size_t unique = stitchRegions<T>(dst, regions, src, pool, scope.resource(), same_key, combine);
+    if (src != data) {
+        parallelFor(pool, unique, [src, data](size_t begin, size_t end) {
+            std::copy(src + begin, src + end, data + begin);
+        });
+    }
+    return unique;
+}
+
+// LSD radix sort of data[0, n) on bits [low_bit, high_bit) whose last scatter
+// folds equal keys. Digits above the highest one that varies are the same for
+// every key (one OR pass finds them), so the scatter on that digit already
+// puts the keys in final order. Within its share of a bucket each block meets
+// the keys in sorted order, so every (block, digit) writer compacts as it
+// goes; the shares are stitched back into data in bucket order.
+template<class T, class SameKey, class Combine>
+size_t radixSortReduce(T *data, size_t n, unsigned low_bit, unsigned high_bit, ThreadPool &pool,
+                       SortContext *ctx, SameKey same_key, Combine combine) {
+    if (n == 0) return 0;
+
+    // Only the calling thread allocates here, so any context will do
+    ScratchScope scope(ctx);
+    std::pmr::memory_resource *resource = scope.resource();
+    std::pmr::vector<T> scratch(n, resource);
+    size_t blocks = parallelBlocks(n, &pool);
+
+    uint64_t first = radixImage(data[0]);
+    std::pmr::vector<uint64_t> block_bits(blocks, 0, resource);
+    forBlocks(&pool, n, blocks, [&](size_t b, size_t begin, size_t end) {
+        uint64_t bits = 0;
+        for (size_t i = begin; i < end; i++) {
+            bits |= radixImage(data[i]) ^ first;
+        }
+        block_bits[b] = bits;
+    }, resource);
+    uint64_t varying = 0;
+    for (uint64_t bits: block_bits) {
+        varying |= bits;
+    }
+    unsigned top_shift = low_bit;
+    for (unsigned shift = low_bit; shift < high_bit; shift += RADIX_BITS) {
+        if ((varying >> shift) & (RADIX_BUCKETS - 1)) {
+            top_shift = shift;
+        }
+    }
+
+    lsdRadixSort(data, scratch.data(), n, low_bit, top_shift, &pool, resource);
+
+    auto digit = [top_shift](T key) { return (radixImage(key) >> top_shift) & (RADIX_BUCKETS - 1); };
+    std::pmr::vector<std::array<size_t, RADIX_BUCKETS>> starts(blocks, resource);
+    forBlocks(&pool, n, blocks, [&](size_t b, size_t begin, size_t end) {
+        starts[b].fill(0);
+        for (size_t i = begin; i < end; i++) {
+            starts[b][digit(data[i])]++;
+        }
+    }, resource);
+    size_t offset = 0;
+    for (size_t d = 0; d < RADIX_BUCKETS; d++) {
+        for (size_t b = 0; b < blocks; b++) {
+            size_t count = starts[b][d];
+            starts[b][d] = offset;
+            offset += count;
+        }
+    }
+
+    std::pmr::vector<std::array<size_t, RADIX_BUCKETS>> written(blocks, resource);
+    T *out = scratch.data();
+    forBlocks(&pool, n, blocks, [&](size_t b, size_t begin, size_t end) {
+        std::array<size_t, RADIX_BUCKETS> &count = written[b];
+        count.fill(0);
+        for (size_t i = begin; i < end; i++) {
+            size_t d = digit(data[i]);
+            appendFolded(out + starts[b][d], count[d], data[i], same_key, combine);
+        }
+    }, resource);
+
+    std::pmr::vector<OutputRegion> regions(resource);
+    regions.reserve(RADIX_BUCKETS * blocks);
+    for (size_t d = 0; d < RADIX_BUCKETS; d++) {
+        for (size_t b = 0; b < blocks; b++) {
+            if (written[b][d] > 0) {
+                regions.push_back({starts[b][d], written[b][d]});
+            }
+        }
+    }
+    return stitchRegions<T>(out, regions, data, pool, resource, same_key, combine);
+}
+
+// Sort packed (key, low) pairs and fold the low halves of equal keys with
+// combine_low, leaving the compacted pairs at the front of packed
+template<class CombineLow>
+size_t sortReducePacked(std::span<int64_t> packed, ThreadPool &pool, SortEngine engine, SortContext *ctx,
+                        CombineLow combine_low) {
+    auto same_key = [](int64_t a, int64_t b) { return unpackKey(a) == unpackKey(b); };
+    auto combine = [&combine_low](int64_t a, int64_t b) {
+        return packKey(unpackKey(a), combine_low(unpackLow(a), unpackLow(b)));
+    };
+    if (engine == SortEngine::Radix) {
+        return radixSortReduce(packed.data(), packed.size(), 32, 64, pool, ctx, same_key, combine);
+    }
+    return mergeSortReduce(packed.data(), packed.size(), pool, ctx, same_key, combine);
+}
+
+// Unpack the first `count` pairs into keys and values, shrinking both to count
+void unpackCompacted(std::span<const int64_t> packed, size_t count, std::vector<int> &keys,
+                     std::vector<uint32_t> &values, ThreadPool &pool) {
+    keys.resize(count);
+    values.resize(count);
+    parallelFor(pool, count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            keys[i] = unpackKey(packed[i]);
+            values[i] = unpackLow(packed[i]);
+        }
+    });
+}
+
+} // namespace
+
+size_t sortUnique(std::vector<int> &keys, ThreadPool &pool, SortEngine engine, SortContext *ctx) {
+    auto same_key = [](int a, int b) { return a == b; };
+    auto keep_first = [](int a, int) { return a; };
+    size_t unique = engine == SortEngine::Radix
+                        ? radixSortReduce(keys.data(), keys.size(), 0, 32, pool, ctx, same_key, keep_first)
+                        : mergeSortReduce(keys.data(), keys.size(), pool, ctx, same_key, keep_first);
+    keys.resize(unique);
+    return unique;
+}
+
+size_t sortCountByKey(std::vector<int> &keys, std::vector<uint32_t> &counts, ThreadPool &pool, SortEngine engine,
+                      SortContext *ctx) {
+    if (keys.size() > UINT32_MAX) {
+        throw std::length_error("sortCountByKey: 2^32 or more keys would overflow the 32-bit counts");
+    }
+    ScratchScope scope(ctx);
+    std::pmr::vector<int64_t> packed(keys.size(), scope.resource());
+    parallelFor(pool, keys.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            packed[i] = packKey(keys[i], 1);
+        }
+    });
+    size_t unique = sortReducePacked(packed, pool, engine, ctx, [](uint32_t a, uint32_t b) { return a + b; });
+    unpackCompacted(packed, unique, keys, counts, pool);
+    return unique;
+}
+
+size_t sortReduceByKey(std::vector<int> &keys, std::vector<uint32_t> &values, ThreadPool &pool,
+                       const std::function<uint32_t(uint32_t, uint32_t)> &op, SortEngine engine, SortContext *ctx) {
+    if (values.size() != keys.size()) {
+        throw std::invalid_argument("sortReduceByKey: values.size() differs from keys.size()");
+    }
+    ScratchScope scope(ctx);
+    std::pmr::vector<int64_t> packed(keys.size(), scope.resource());
+    if (engine == SortEngine::Merge && keys.size() <= UINT32_MAX) {
+        // Merge sort compares whole words, so it gets (key, input index)
+        // pairs: equal keys then meet in input order, as in the radix engine.
+        // A group's running value lives at values[index of its first pair].
+        packWithIndex(keys, packed, pool);
+        auto same_key = [](int64_t a, int64_t b) { return unpackKey(a) == unpackKey(b); };
+        auto fold = [&values, &op](int64_t kept, int64_t next) {
+            uint32_t &value = values[unpackLow(kept)];
+            value = op(value, values[unpackLow(next)]);
+            return kept;
+        };
+        size_t unique = mergeSortReduce(packed.data(), packed.size(), pool, ctx, same_key, fold);
+        parallelFor(pool, unique, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                packed[i] = packKey(unpackKey(packed[i]), values[unpackLow(packed[i])]);
+            }
+        });
+        unpackCompacted(packed, unique, keys, values, pool);
+        return unique;
+    }
+
+    parallelFor(pool, keys.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            packed[i] = packKey(keys[i], values[i]);
+        }
+    });
+    // Radix reads only the key half, so it folds in input order as it is
+    size_t unique = sortReducePacked(packed, pool, SortEngine::Radix, ctx, op);
+    unpackCompacted(packed, unique, keys, values, pool);
+    return unique;
+}
+
+// ============================================
+// Selection: nth element, partial sort, top-k
+// ============================================
+
+namespace {
+
+// Ranges at most this long finish with std::nth_element's introselect
+constexpr size_t PARALLEL_SELECT_THRESHOLD = 1 << 16;
+
+// Elements sampled to pick a partitioning pivot
+constexpr size_t PIVOT_SAMPLE_SIZE = 127;
+
+// Smallest block a partitioning or top-k task works on
+constexpr size_t MIN_SELECT_BLOCK = 1 << 14;
+
+// Median of an evenly spaced sample of data[0, n)
+int samplePivot(const int *data, size_t n) {
+    std::array<int, PIVOT_SAMPLE_SIZE> sample;
+    size_t step = n / PIVOT_SAMPLE_SIZE;
+    for (size_t i = 0; i < PIVOT_SAMPLE_SIZE; i++) {
+        sample[i] = data[i * step + step / 2];
+    }
+    std::nth_element(sample.begin(), sample.begin() + PIVOT_SAMPLE_SIZE / 2, sample.end());
+    return sample[PIVOT_SAMPLE_SIZE / 2];
+}
+
+struct PartitionCounts {
+    size_t less;
+    size_t equal;
+};
+
+// Three-way partition data[0, n) into [< pivot][== pivot][> pivot] on the pool:
+// every block counts its classes, then scatters them to their final offsets in
+// scratch, which is copied back
+PartitionCounts partitionParallel(int *data, size_t n, int pivot, int *scratch, ThreadPool &pool,
+                                  SortContext *ctx) {
+    size_t blocks = std::clamp<size_t>(n / MIN_SELECT_BLOCK, 1, std::max<size_t>(1, pool.size()) * 4);
+    size_t block_size = (n + blocks - 1) / blocks;
+    blocks = (n + block_size - 1) / block_size;
+
+    ScratchScope scope(ctx);
+    std::pmr::vector<size_t> less(blocks, scope.resource()), equal(blocks, scope.resource());
+    std::pmr::vector<std::future<void>> futures(scope.resource());
+    futures.reserve(blocks);
+    for (size_t b = 0; b < blocks; b++) {
+        futures.push_back(pool.submit([data, n, pivot, block_size, b, &less, &equal]() {
+            size_t lt = 0, eq = 0;
+            for (size_t i = b * block_size; i < std::min(n, (b + 1) * block_size); i++) {
+                lt += data[i] < pivot;
+                eq += data[i] == pivot;
+            }
+            less[b] = lt;
+            equal[b] = eq;
+        }));
+    }
+    for (auto &fut: futures) {
+        fut.get();
+    }
+
+    PartitionCounts counts{0, 0};
+    for (size_t b = 0; b < blocks; b++) {
+        counts.less += less[b];
+        counts.equal += equal[b];
+    }
+
+    // Each block's first output slot in every class
+    std::pmr::vector<size_t> less_at(blocks, scope.resource());
+    std::pmr::vector<size_t> equal_at(blocks, scope.resource());
+    std::pmr::vector<size_t> greater_at(blocks, scope.resource());
+    size_t lt = 0, eq = counts.less, gt = counts.less + counts.equal;
+    for (size_t b = 0; b < blocks; b++) {
+        size_t length = std::min(n, (b + 1) * block_size) - b * block_size;
+        less_at[b] = lt;
+        equal_at[b] = eq;
+        greater_at[b] = gt;
+        lt += less[b];
+        eq += equal[b];
+        gt += length - less[b] - equal[b];
+    }
+
+    futures.clear();
+    for (size_t b = 0; b < blocks; b++) {
+        futures.push_back(pool.submit([=, &less_at, &equal_at, &greater_at]() {
+            size_t lt_out = less_at[b], eq_out = equal_at[b], gt_out = greater_at[b];
+            for (size_t i = b * block_size; i < std::min(n, (b + 1) * block_size); i++) {
+                int value = data[i];
+                if (value < pivot) scratch[lt_out++] = value;
+                else if (value == pivot) scratch[eq_out++] = value;
+                else scratch[gt_out++] = value;
+            }
+        }));
+    }
+    for (auto &fut: futures) {
+        fut.get();
+    }
+
+    futures.clear();
+    for (size_t b = 0; b < blocks; b++) {
+        futures.push_back(pool.submit([=]() {
+            std::copy(scratch + b * block_size, scratch + std::min(n, (b + 1) * block_size), data + b * block_size);
+        }));
+    }
+    for (auto &fut: futures) {
+        fut.get();
+    }
+    return counts;
+}
+
+void nthElementRange(std::span<int> data, size_t nth, ThreadPool &pool, SortContext *ctx) {
+    if (nth >= data.size()) return;
+
+    // Introselect: parallel sample-pivot partitioning narrows the range, and
+    // std::nth_element takes over once it is small or progress stalls
+    ScratchScope scope(ctx);
+    size_t begin = 0;
+    size_t end = data.size();
+    size_t rounds_left = 2 * static_cast<size_t>(std::log2(static_cast<double>(data.size())) + 1);
+    std::pmr::vector<int> scratch(scope.resource());
+    while (end - begin > PARALLEL_SELECT_THRESHOLD && rounds_left-- > 0) {
+        if (scratch.empty()) {
+            scratch.resize(end - begin);
+        }
+        int pivot = samplePivot(data.data() + begin, end - begin);
+        PartitionCounts counts = partitionParallel(data.data() + begin, end - begin, pivot, scratch.data(), pool,
+                                                   ctx);
+
+        size_t less_end = begin + counts.less;
+        size_t equal_end = less_end + counts.equal;
+        if (nth < less_end) {
+            end = less_end;
+        } else if (nth < equal_end) {
+            return;
+        } else {
+            begin = equal_end;
+        }
+    }
+    std::nth_element(data.begin() + begin, data.begin() + nth, data.begin() + end);
+}
+
+void partialSortRange(std::span<int> data, size_t k, ThreadPool &pool, SortContext *ctx) {
+    k = std::min(k, data.size());
+    if (k == 0) return;
+
+    if (k < data.size()) {
+        nthElementRange(data, k, pool, ctx);
+    }
+    if (k > PARALLEL_SELECT_THRESHOLD) {
+        mergeSortThreadPool(data.first(k), pool, ctx);
+    } else {
+        std::sort(data.begin(), data.begin() + k);
+    }
+}
+
+} // namespace
+
+void nthElementParallel(std::vector<int> &arr, size_t nth, ThreadPool &pool, SortContext *ctx) {
+    nthElementRange(arr, nth, pool, ctx);
+}
+
+void partialSortParallel(std::vector<int> &arr, size_t k, ThreadPool &pool, SortContext *ctx) {
+    partialSortRange(arr, k, pool, ctx);
+}
+
+std::vector<int> topK(const std::vector<int> &arr, size_t k, ThreadPool &pool, SortContext *ctx) {
+    size_t n = arr.size();
+    k = std::min(k, n);
+    if (k == 0) return {};
+
+    // Bounded heaps only pay off while each block is much larger than k
+    ScratchScope scope(ctx);
+    size_t blocks = std::clamp<size_t>(n / std::max(MIN_SELECT_BLOCK, 8 * k), 1,
+                                       std::max<size_t>(1, pool.size()) * 4);
+    if (blocks == 1 && k * 8 > n) {
+        std::pmr::vector<int> values(arr.begin(), arr.end(), scope.resource());
+        partialSortRange(values, k, pool, ctx);
+        return std::vector<int>(values.begin(), values.begin() + k);
+    }
+
+    // Every block keeps the k smallest elements it has seen in a max-heap in
+    // its own k slots of the candidate buffer. Only the last block can be
+    // shorter than k, so the candidates end up contiguous.
+    size_t block_size = (n + blocks - 1) / blocks;
+    std::pmr::vector<int> candidates(scope.resource());
+    candidates.resize(((n + block_size - 1) / block_size) * k);
+    std::pmr::vector<std::future<void>> futures(scope.resource());
+    futures.reserve(blocks);
+    const int *data = arr.data();
+    int *heaps = candidates.data();
+    size_t candidate_count = 0;
+    for (size_t start = 0; start < n; start += block_size) {
+        size_t stop = std::min(n, start + block_size);
+        size_t seed_end = std::min(stop, start + k);
+        int *heap = heaps + (start / block_size) * k;
+        candidate_count += seed_end - start;
+        futures.push_back(pool.submit([data, heap, start, seed_end, stop]() {
+            size_t size = seed_end - start;
+            std::copy(data + start, data + seed_end, heap);
+            std::make_heap(heap, heap + size);
+
+            // Most elements fail the threshold test, so keep it in a register
+            int threshold = heap[0];
+            for (size_t i = seed_end; i < stop; i++) {
+                if (data[i] < threshold) {
+                    std::pop_heap(heap, heap + size);
+                    heap[size - 1] = data[i];
+                    std::push_heap(heap, heap + size);
+                    threshold = heap[0];
+                }
+            }
+        }));
+    }
+    for (auto &fut: futures) {
+        fut.get();
+    }
+
+    std::nth_element(heaps, heaps + (k - 1), heaps + candidate_count);
+    std::sort(heaps, heaps + k);
+    return std::vector<int>(heaps, heaps + k);
+}
+
+// ============================================
+// Verification function
+// ============================================
+
+bool isSorted(const std::vector<int> &arr) {
+    for (size_t i = 1; i < arr.size(); i++) {
+        if (arr[i] < arr[i - 1]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============================================
+// Algorithm registrations
+// ============================================
+
+namespace {
+
+// Scratch context owned by one instantiated sort, when the run reuses scratch memory
+std::shared_ptr<SortContext> makeContext(const SortEnvironment &env) {
+    return env.reuse_scratch ? std::make_shared<SortContext>(env.pool) : nullptr;
+}
+
+const AlgorithmRegistrar register_merge_single({
+    "merge-single", "Single-Threaded Merge Sort",
+    CAP_STABLE, KEY_INT32, ExtraMemory::Linear,
+    [](const SortEnvironment &env) {
+        auto ctx = makeContext(env);
+        return SortFunction([ctx](std::vector<int> &arr) { mergeSortSingleThreaded(arr, ctx.get()); });
+    },
+    ""
+});
+
+const AlgorithmRegistrar register_merge_threads({
+    "merge-threads", "Multi-Threaded Merge Sort (Recursive)",
+    CAP_STABLE | CAP_PARALLEL, KEY_INT32, ExtraMemory::Linear,
+    [](const SortEnvironment &env) {
+        int thread_count = env.thread_count;
+        auto ctx = makeContext(env);
+        return SortFunction([thread_count, ctx](std::vector<int> &arr) {
+            mergeSortMultiThreaded(arr, thread_count, ctx.get());
+        });
+    },
+    "merge-single"
+});
+
+const AlgorithmRegistrar register_merge_pool({
+    "merge-pool", "Multi-Threaded Merge Sort (ThreadPool)",
+    CAP_STABLE | CAP_PARALLEL | CAP_NEEDS_THREADPOOL, KEY_INT32 | KEY_INT64, ExtraMemory::Linear,
+    [](const SortEnvironment &env) {
+        ThreadPool *pool = &env.pool;
+        auto ctx = makeContext(env);
+        return SortFunction([pool, ctx](std::vector<int> &arr) {
+            mergeSortThreadPool(arr, *pool, ctx.get());
+        });
+    },
+    "merge-single"
+});
+
+const AlgorithmRegistrar register_quick({
+    "quick", "Quick Sort",
+    CAP_IN_PLACE, KEY_INT32, ExtraMemory::Logarithmic,
+    [](const SortEnvironment &) { return SortFunction(quickSort); },
+    ""
+});
+
+const AlgorithmRegistrar register_quick_dual({
+    "quick-dual", "Dual-Pivot Quick Sort",
+    CAP_IN_PLACE, KEY_INT32, ExtraMemory::Logarithmic,
+    [](const SortEnvironment &) { return SortFunction(dualPivotQuickSort); },
+    "quick"
+});
+
+const AlgorithmRegistrar register_bitonic({
+    "bitonic", "Bitonic Sort",
+    CAP_IN_PLACE, KEY_INT32, ExtraMemory::Constant,
+    [](const SortEnvironment &) { return SortFunction(bitonicSort); },
+    "stl"
+});
+
+const AlgorithmRegistrar register_bitonic_pool({
+    "bitonic-pool", "Bitonic Sort (ThreadPool)",
+    CAP_IN_PLACE | CAP_PARALLEL | CAP_NEEDS_THREADPOOL, KEY_INT32, ExtraMemory::Constant,
+    [](const SortEnvironment &env) {
+        ThreadPool *pool = &env.pool;
+        return SortFunction([pool](std::vector<int> &arr) { bitonicSortParallel(arr, *pool); });
+    },
+    "bitonic"
+});
+
+const AlgorithmRegistrar register_heap({
+    "heap", "Heap Sort",
+    CAP_IN_PLACE, KEY_INT32, ExtraMemory::Logarithmic,
+    [](const SortEnvironment &) { return SortFunction(heapSort); },
+    ""
+});
+
+const AlgorithmRegistrar register_stl({
+    "stl", "STL Sort (std::sort)",
+    CAP_IN_PLACE, KEY_INT32 | KEY_INT64, ExtraMemory::Logarithmic,
+    [](const SortEnvironment &) { return SortFunction([](std::vector<int> &arr) { stlSort(arr); }); },
+    ""
+});
+
+const AlgorithmRegistrar register_natural_merge({
+    "natural-merge", "Adaptive Natural Merge Sort (Powersort)",
+    CAP_STABLE, KEY_INT32, ExtraMemory::Linear,
+    [](const SortEnvironment &env) {
+        auto ctx = makeContext(env);
+        return SortFunction([ctx](std::vector<int> &arr) { naturalMergeSort(arr, ctx.get()); });
+    },
+    "merge-single"
+});
+
+const AlgorithmRegistrar register_natural_merge_pool({
+    "natural-merge-pool", "Adaptive Natural Merge Sort (ThreadPool)",
+    CAP_STABLE | CAP_PARALLEL | CAP_NEEDS_THREADPOOL, KEY_INT32, ExtraMemory::Linear,
+    [](const SortEnvironment &env) {
+        ThreadPool *pool = &env.pool;
+        auto ctx = makeContext(env);
+        return SortFunction([pool, ctx](std::vector<int> &arr) {
+            naturalMergeSortParallel(arr, *pool, ctx.get());
+        });
+    },
+    "natural-merge"
+});
+
+const AlgorithmRegistrar register_merge_inplace({
+    "merge-inplace", "In-Place Merge Sort (SymMerge)",
+    CAP_STABLE | CAP_IN_PLACE, KEY_INT32, ExtraMemory::Logarithmic,
+    [](const SortEnvironment &) { return SortFunction([](std::vector<int> &arr) { inPlaceMergeSort(arr); }); },
+    "merge-single"
+});
+
+const AlgorithmRegistrar register_merge_inplace_pool({
+    "merge-inplace-pool", "In-Place Merge Sort (ThreadPool)",
+    CAP_STABLE | CAP_IN_PLACE | CAP_PARALLEL | CAP_NEEDS_THREADPOOL, KEY_INT32, ExtraMemory::Logarithmic,
+    [](const SortEnvironment &env) {
+        ThreadPool *pool = &env.pool;
+        auto ctx = makeContext(env);
+        return SortFunction([pool, ctx](std::vector<int> &arr) {
+            inPlaceMergeSortParallel(arr, *pool, ctx.get());
+        });
+    },
+    "merge-inplace"
+});
+
+const AlgorithmRegistrar register_radix_lsd({
+    "radix-lsd", "LSD Radix Sort",
+    CAP_STABLE, KEY_INT32, ExtraMemory::Linear,
+    [](const SortEnvironment &env) {
+        auto ctx = makeContext(env);
+        return SortFunction([ctx](std::vector<int> &arr) { radixSortLSD(arr, ctx.get()); });
+    },
+    "stl"
+});
+
+const AlgorithmRegistrar register_radix_lsd_pool({
+    "radix-lsd-pool", "LSD Radix Sort (ThreadPool)",
+    CAP_STABLE | CAP_PARALLEL | CAP_NEEDS_THREADPOOL, KEY_INT32, ExtraMemory::Linear,
+    [](const SortEnvironment &env) {
+        ThreadPool *pool = &env.pool;
+        auto ctx = makeContext(env);
+        return SortFunction([pool, ctx](std::vector<int> &arr) {
+            radixSortLSD(arr, *pool, ctx.get());
+        });
+    },
+    "radix-lsd"
+});
+
+const AlgorithmRegistrar register_radix_msd({
+    "radix-msd", "In-Place MSD Radix Sort (American Flag)",
+    CAP_IN_PLACE, KEY_INT32, ExtraMemory::Logarithmic,
+    [](const SortEnvironment &) { return SortFunction([](std::vector<int> &arr) { radixSortMSD(arr); }); },
+    "radix-lsd"
+});
+
+const AlgorithmRegistrar register_radix_msd_pool({
+    "radix-msd-pool", "In-Place MSD Radix Sort (ThreadPool)",
+    CAP_IN_PLACE | CAP_PARALLEL | CAP_NEEDS_THREADPOOL, KEY_INT32, ExtraMemory::Logarithmic,
+    [](const SortEnvironment &env) {
+        ThreadPool *pool = &env.pool;
+        auto ctx = makeContext(env);
+        return SortFunction([pool, ctx](std::vector<int> &arr) { radixSortMSD(arr, *pool, ctx.get()); });
+    },
+    "radix-msd"
+});
+
+const AlgorithmRegistrar register_segmented_loop({
+    "segmented-loop", "Per-Segment std::sort",
+    CAP_IN_PLACE | CAP_SEGMENTED, KEY_INT32, ExtraMemory::Logarithmic,
+    nullptr,
+    "",
+    [](const SortEnvironment &) {
+        return SegmentedSortFunction([](std::vector<int> &values, const std::vector<size_t> &offsets) {
+            for (size_t s = 0; s + 1 < offsets.size(); s++) {
+                std::sort(values.begin() + offsets[s], values.begin() + offsets[s + 1]);
+            }
+        });
+    }
+});
+
+const AlgorithmRegistrar register_segmented_single({
+    "segmented-single", "Segmented Sort (Single-Threaded)",
+    CAP_IN_PLACE | CAP_SEGMENTED, KEY_INT32, ExtraMemory::Logarithmic,
+    nullptr,
+    "segmented-loop",
+    [](const SortEnvironment &) {
+        return SegmentedSortFunction([](std::vector<int> &values, const std::vector<size_t> &offsets) {
+            segmentedSort(values, offsets);
+        });
+    }
+});
+
+const AlgorithmRegistrar register_segmented_pool({
+    "segmented-pool", "Segmented Sort (ThreadPool)",
+    CAP_IN_PLACE | CAP_PARALLEL | CAP_NEEDS_THREADPOOL | CAP_SEGMENTED, KEY_INT32, ExtraMemory::Logarithmic,
+    nullptr,
+    "segmented-loop",
+    [](const SortEnvironment &env) {
+        ThreadPool *pool = &env.pool;
+        auto ctx = makeContext(env);
+        return SegmentedSortFunction([pool, ctx](std::vector<int> &values, const std::vector<size_t> &offsets) {
+            segmentedSort(values, offsets, *pool, ctx.get());
+        });
+    }
+});
+
+} // namespace
@@ -1,29 +1,195 @@
 #ifndef SORTING_ALGORITHMS_H
 #define SORTING_ALGORITHMS_H
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <span>
 #include <vector>
+#include "sort_context.h"
 
 // Forward declaration
 class ThreadPool;
 
+// Sorts that need scratch memory take an optional SortContext: with one, the
+// scratch comes from the context's reusable arenas instead of the heap (see
+// sort_context.h). quickSort, dualPivotQuickSort, bitonicSort, heapSort and
+// stlSort never allocate.
+
 // Single-threaded merge sort
-void mergeSortSingleThreaded(std::vector<int> & arr);
+void mergeSortSingleThreaded(std::vector<int> & arr, SortContext *ctx = nullptr);
 
 // Multi-threaded merge sort (recursive)
-void mergeSortMultiThreaded(std::vector<int> &arr, int thread_count);
+void mergeSortMultiThreaded(std::vector<int> &arr, int thread_count, SortContext *ctx = nullptr);
 
 // ThreadPool-based merge sort
-void mergeSortThreadPool(std::vector<int> &arr, ThreadPool &pool);
+void mergeSortThreadPool(std::vector<int> &arr, ThreadPool &pool, SortContext *ctx = nullptr);
+
+// ThreadPool-based merge sort of any contiguous range, e.g. a memory-mapped file
+void mergeSortThreadPool(std::span<int> data, ThreadPool &pool, SortContext *ctx = nullptr);
+
+void mergeSortThreadPool(std::span<int64_t> data, ThreadPool &pool, SortContext *ctx = nullptr);
+
+// Adaptive natural merge sort (powersort): detects ascending runs, reverses
+// descending ones, extends short runs by binary insertion and merges with
+// galloping. Stable; already sorted or reversed input takes O(n).
+void naturalMergeSort(std::vector<int> &arr, SortContext *ctx = nullptr);
+
+// Natural merge sort of one chunk per pool worker, then a parallel k-way merge
+// of the chunks that are not already in order with their neighbours
+void naturalMergeSortParallel(std::vector<int> &arr, ThreadPool &pool, SortContext *ctx = nullptr);
+
+// Stable merge sort without a merge buffer: insertion-sorted blocks merged by
+// SymMerge (binary-search split plus rotation). O(n log^2 n) time and only the
+// O(log n) recursion stack as extra memory.
+void inPlaceMergeSort(std::vector<int> &arr);
+
+// In-place merge sort of one chunk per task, then level-by-level SymMerges on
+// the pool. Merges are split into independent halves until every worker has
+// work, so extra memory stays O(log n) plus a few job records per worker.
+void inPlaceMergeSortParallel(std::vector<int> &arr, ThreadPool &pool, SortContext *ctx = nullptr);
 
 // Quick sort (single-threaded)
 void quickSort(std::vector<int> & arr);
 
+// Dual-pivot quick sort (single-threaded): pivots from five sorted samples, a
+// three-way split per pass (with an == pivot part when the pivots are equal),
+// insertion sort below 32 elements and heap sort past 2 log2 n levels
+void dualPivotQuickSort(std::vector<int> &arr);
+
+// Bitonic sorting network: O(n log^2 n) branch-free compare-exchanges whose
+// sequence depends only on n, so the running time does not depend on the
+// keys. Any n; positions past n act as +infinity.
+void bitonicSort(std::vector<int> &arr);
+
+// Bitonic sort with every step's compare-exchanges split across the calling
+// thread and the pool's workers. Steps are fanned out and joined in phases,
+// with a join only where a step crosses the tasks' chunks; no task waits on
+// another, so any number of threads may share the pool. Called from one of the
+// pool's own workers it sorts alone.
+void bitonicSortParallel(std::vector<int> &arr, ThreadPool &pool);
+
 // Heap sort (single-threaded)
 void heapSort(std::vector<int> & arr);
 
 // STL sort (for reference/baseline)
 void stlSort(std::vector<int> & arr);
 
+void stlSort(std::span<int> data);
+
+void stlSort(std::span<int64_t> data);
+
+// Segmented sort: sorts every segment [offsets[i], offsets[i + 1]) of a flat buffer
+// independently. offsets.front() must be 0 and offsets.back() values.size().
+void segmentedSort(std::vector<int> &values, const std::vector<size_t> &offsets);
+
+// Segmented sort with segments distributed across the pool by estimated work
+void segmentedSort(std::vector<int> &values, const std::vector<size_t> &offsets, ThreadPool &pool,
+                   SortContext *ctx = nullptr);
+
+// Stable LSD radix sort, 8 bits per pass, skipping passes where every key shares the digit
+void radixSortLSD(std::vector<int> &arr, SortContext *ctx = nullptr);
+
+// LSD radix sort with per-block histograms and scatters on the pool
+void radixSortLSD(std::vector<int> &arr, ThreadPool &pool, SortContext *ctx = nullptr);
+
+// In-place MSD radix sort (American flag sort), 8 bits per level from the top:
+// keys are swapped along cycles straight into their buckets, buckets of at
+// most 128 keys go to the dual-pivot quick sort. No n-sized buffer; extra
+// memory is a few digit tables per recursion level.
+void radixSortMSD(std::vector<int> &arr);
+
+// American flag sort with the top-level counts and the in-place permutation
+// split into stripes on the pool, then one task per bucket
+void radixSortMSD(std::vector<int> &arr, ThreadPool &pool, SortContext *ctx = nullptr);
+
+// Run body(begin, end) over slices of [0, n) on the pool and wait for all of them
+void parallelFor(ThreadPool &pool, size_t n, const std::function<void(size_t, size_t)> &body);
+
+// Sort engine behind the key-value sorts and argsort
+enum class SortEngine {
+    Merge,    // mergeSortThreadPool
+    Radix     // parallel LSD radix sort
+};
+
+// Stable sort order of keys: keys[order[0]] <= keys[order[1]] <= ..., equal keys
+// in input order. Sorts packed (key, index) pairs; keys.size() must be below 2^32.
+std::vector<uint32_t> argsort(const std::vector<int> &keys, ThreadPool &pool,
+                              SortEngine engine = SortEngine::Radix, SortContext *ctx = nullptr);
+
+// As above, writing the order to `order` (keys.size() entries) instead of a new vector
+void argsort(const std::vector<int> &keys, std::span<uint32_t> order, ThreadPool &pool,
+             SortEngine engine = SortEngine::Radix, SortContext *ctx = nullptr);
+
+// Sort keys and apply the same permutation to values (e.g. row ids). The
+// payload is packed next to the key, so equal keys may come out in any order.
+void sortByKey(std::vector<int> &keys, std::vector<uint32_t> &values, ThreadPool &pool,
+               SortEngine engine = SortEngine::Radix, SortContext *ctx = nullptr);
+
+// As sortByKey, but equal keys keep their input order. Inputs of 2^32 keys or
+// more always use the radix engine.
+void stableSortByKey(std::vector<int> &keys, std::vector<uint32_t> &values, ThreadPool &pool,
+                     SortEngine engine = SortEngine::Radix, SortContext *ctx = nullptr);
+
+// Stable key-value sort for payloads of any width: argsort the keys, then
+// gather keys and payloads in one pass with sequential writes and copy them
+// back. Limited to fewer than 2^32 keys, as argsort is.
+template<class Payload>
+void sortByKeyGather(std::vector<int> &keys, std::vector<Payload> &payload, ThreadPool &pool,
+                     SortEngine engine = SortEngine::Radix, SortContext *ctx = nullptr) {
+    ScratchScope scope(ctx);
+    std::pmr::vector<uint32_t> order(keys.size(), scope.resource());
+    argsort(keys, order, pool, engine, ctx);
+    std::pmr::vector<int> sorted_keys(keys.size(), scope.resource());
+    std::pmr::vector<Payload> sorted_payload(payload.size(), scope.resource());
+    parallelFor(pool, keys.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            sorted_keys[i] = keys[order[i]];
+            sorted_payload[i] = std::move(payload[order[i]]);
+        }
+    });
+    parallelFor(pool, keys.size(), [&](size_t begin, size_t end) {
+        std::copy(sorted_keys.begin() + begin, sorted_keys.begin() + end, keys.begin() + begin);
+        std::move(sorted_payload.begin() + begin, sorted_payload.begin() + end, payload.begin() + begin);
+    });
+}
+
+// Sort keys and drop duplicates inside the engine's last pass (the final
+// k-way merge, or the scatter on the highest radix digit that varies) instead
+// of in a second pass over the sorted array. keys is shrunk to the distinct
+// keys in ascending order; returns how many there are.
+size_t sortUnique(std::vector<int> &keys, ThreadPool &pool, SortEngine engine = SortEngine::Radix,
+                  SortContext *ctx = nullptr);
+
+// sortUnique that also counts: counts[i] is how often keys[i] occurred in the
+// input. Counts are 32-bit, so larger inputs throw std::length_error.
+size_t sortCountByKey(std::vector<int> &keys, std::vector<uint32_t> &counts, ThreadPool &pool,
+                      SortEngine engine = SortEngine::Radix, SortContext *ctx = nullptr);
+
+// Group-by in one sort: sort by key and fold the values of equal keys with op
+// in the same fused last pass, leaving one (key, value) pair per distinct key.
+// values must be as long as keys (std::invalid_argument otherwise).
+// Both engines fold equal keys in input order, so op need only be associative
+// (e.g. "keep the first" gives the same result either way). Inputs of 2^32
+// keys or more always use the radix engine.
+size_t sortReduceByKey(std::vector<int> &keys, std::vector<uint32_t> &values, ThreadPool &pool,
+                       const std::function<uint32_t(uint32_t, uint32_t)> &op, SortEngine engine = SortEngine::Radix,
+                       SortContext *ctx = nullptr);
+
+// Rearrange arr so arr[nth] is the element a full sort would put there, with
+// nothing greater before it and nothing smaller after it. Large ranges are
+// partitioned on the pool around sampled pivots; std::nth_element finishes.
+void nthElementParallel(std::vector<int> &arr, size_t nth, ThreadPool &pool, SortContext *ctx = nullptr);
+
+// Sort only the k smallest elements into arr[0, k); the rest is left in unspecified order
+void partialSortParallel(std::vector<int> &arr, size_t k, ThreadPool &pool, SortContext *ctx = nullptr);
+
+// The k smallest elements of arr in ascending order, found with per-block
+// bounded heaps on the pool; arr is left untouched
+std::vector<int> topK(const std::vector<int> &arr, size_t k, ThreadPool &pool, SortContext *ctx = nullptr);
+
 // Utility function to verify if array is sorted
 bool isSorted(const std::vector<int> &arr);
 
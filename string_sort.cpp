@@ -0,0 +1,310 @@
+#include "string_sort.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <future>
+
+// ============================================
+// StringArena
+// ============================================
+
+void StringArena::reserve(size_t strings, size_t bytes) {
+    offsets_.reserve(strings + 1);
+    bytes_.reserve(bytes);
+}
+
+void StringArena::append(std::string_view text) {
+    bytes_.insert(bytes_.end(), text.begin(), text.end());
+    offsets_.push_back(bytes_.size());
+}
+
+std::vector<std::string_view> StringArena::views() const {
+    std::vector<std::string_view> result(size());
+    for (size_t i = 0; i < result.size(); i++) {
+        result[i] = (*this)[i];
+    }
+    return result;
+}
+
+namespace {
+
+// Ranges this short are finished by insertion sort
+constexpr size_t STRING_INSERTION_THRESHOLD = 16;
+
+// Strings that share their first `depth` characters, compared from there on
+bool lessFrom(std::string_view a, std::string_view b, size_t depth) {
+    return a.substr(depth) < b.substr(depth);
+}
+
+template<class T, class Less>
+void insertionSortBy(T *data, size_t n, Less less) {
+    for (size_t i = 1; i < n; i++) {
+        T value = data[i];
+        size_t j = i;
+        while (j > 0 && less(value, data[j - 1])) {
+            data[j] = data[j - 1];
+            j--;
+        }
+        data[j] = value;
+    }
+}
+
+// ============================================
+// Multikey quicksort
+// ============================================
+
+// Character at `depth` as 0-255, or -1 past the end, so shorter strings sort first
+inline int charAt(std::string_view text, size_t depth) {
+    return depth < text.size() ? static_cast<unsigned char>(text[depth]) : -1;
+}
+
+// Sort strings[0, n), which share their first `depth` characters. Recurses
+// into the < and == parts and loops on the > part.
+void multikeyRange(std::string_view *strings, size_t n, size_t depth) {
+    while (n > STRING_INSERTION_THRESHOLD) {
+        int a = charAt(strings[0], depth);
+        int b = charAt(strings[n / 2], depth);
+        int c = charAt(strings[n - 1], depth);
+        int pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+
+        size_t less = 0, i = 0, greater = n;
+        while (i < greater) {
+            int ch = charAt(strings[i], depth);
+            if (ch < pivot) {
+                std::swap(strings[less++], strings[i++]);
+            } else if (ch > pivot) {
+                std::swap(strings[i], strings[--greater]);
+            } else {
+                i++;
+            }
+        }
+
+        multikeyRange(strings, less, depth);
+        // Strings that all ended at this depth are equal
+        if (pivot >= 0) {
+            multikeyRange(strings + less, greater - less, depth + 1);
+        }
+        strings += greater;
+        n -= greater;
+    }
+    insertionSortBy(strings, n, [depth](std::string_view x, std::string_view y) { return lessFrom(x, y, depth); });
+}
+
+// ============================================
+// MSD radix sort on cached prefixes
+// ============================================
+
+constexpr unsigned PREFIX_BYTES = 8;
+constexpr size_t BYTE_BUCKETS = 256;
+
+struct PrefixedString {
+    uint64_t prefix;    // bytes [depth, depth + 8) big-endian, zero past the end
+    std::string_view text;
+};
+
+uint64_t prefixAt(std::string_view text, size_t depth) {
+    uint64_t prefix = 0;
+    size_t end = std::min(text.size(), depth + PREFIX_BYTES);
+    for (size_t i = depth; i < end; i++) {
+        prefix |= uint64_t(static_cast<unsigned char>(text[i])) << (8 * (PREFIX_BYTES - 1 - (i - depth)));
+    }
+    return prefix;
+}
+
+void msdStringRange(PrefixedString *data, size_t n, size_t depth, unsigned shift);
+
+// data[0, n) agree on the padded bytes [depth, depth + 8). Strings that end
+// within them differ at most in trailing zero bytes, so they go first,
+// shorter first; the rest reload their prefix 8 bytes deeper and continue.
+void finishPrefixGroup(PrefixedString *data, size_t n, size_t depth) {
+    PrefixedString *rest = std::partition(data, data + n, [depth](const PrefixedString &s) {
+        return s.text.size() <= depth + PREFIX_BYTES;
+    });
+    std::sort(data, rest, [](const PrefixedString &a, const PrefixedString &b) {
+        return a.text.size() < b.text.size();
+    });
+    size_t remaining = data + n - rest;
+    for (size_t i = 0; i < remaining; i++) {
+        rest[i].prefix = prefixAt(rest[i].text, depth + PREFIX_BYTES);
+    }
+    msdStringRange(rest, remaining, depth + PREFIX_BYTES, 8 * (PREFIX_BYTES - 1));
+}
+
+// Sort data[0, n), which share their first `depth` characters and the prefix
+// bytes above `shift`, on the prefix byte at `shift` and everything after it
+void msdStringRange(PrefixedString *data, size_t n, size_t depth, unsigned shift) {
+    if (n <= STRING_INSERTION_THRESHOLD) {
+        insertionSortBy(data, n, [depth](const PrefixedString &a, const PrefixedString &b) {
+            if (a.prefix != b.prefix) return a.prefix < b.prefix;
+            return lessFrom(a.text, b.text, depth);
+        });
+        return;
+    }
+
+    auto digit = [shift](const PrefixedString &s) { return (s.prefix >> shift) & (BYTE_BUCKETS - 1); };
+    std::array<size_t, BYTE_BUCKETS> counts{};
+    for (size_t i = 0; i < n; i++) {
+        counts[digit(data[i])]++;
+    }
+    auto next = [&](PrefixedString *group, size_t length) {
+        if (shift > 0) {
+            msdStringRange(group, length, depth, shift - 8);
+        } else {
+            finishPrefixGroup(group, length, depth);
+        }
+    };
+    if (counts[digit(data[0])] == n) {
+        next(data, n);
+        return;
+    }
+
+    std::array<size_t, BYTE_BUCKETS + 1> bounds{};
+    for (size_t d = 0; d < BYTE_BUCKETS; d++) {
+        bounds[d + 1] = bounds[d] + counts[d];
+    }
+    std::array<size_t, BYTE_BUCKETS> heads;
+    std::copy(bounds.begin(), bounds.end() - 1, heads.begin());
+    for (size_t d = 0; d < BYTE_BUCKETS; d++) {
+        while (heads[d] < bounds[d + 1]) {
+            PrefixedString value = data[heads[d]];
+            size_t target = digit(value);
+            while (target != d) {
+                std::swap(value, data[heads[target]++]);
+                target = digit(value);
+            }
+            data[heads[d]++] = value;
+        }
+    }
+
+    for (size_t d = 0; d < BYTE_BUCKETS; d++) {
+        if (bounds[d + 1] - bounds[d] > 1) {
+            next(data + bounds[d], bounds[d + 1] - bounds[d]);
+        }
+    }
+}
+
+void radixRange(std::string_view *strings, size_t n) {
+    std::vector<PrefixedString> prefixed(n);
+    for (size_t i = 0; i < n; i++) {
+        prefixed[i] = {prefixAt(strings[i], 0), strings[i]};
+    }
+    msdStringRange(prefixed.data(), n, 0, 8 * (PREFIX_BYTES - 1));
+    for (size_t i = 0; i < n; i++) {
+        strings[i] = prefixed[i].text;
+    }
+}
+
+// ============================================
+// Parallel sample split
+// ============================================
+
+// Below this many strings the pool version sorts sequentially
+constexpr size_t MIN_PARALLEL_STRINGS = 1 << 14;
+
+// Buckets (and classification blocks) per pool worker
+constexpr size_t STRING_BUCKETS_PER_WORKER = 4;
+
+// Sampled strings per bucket
+constexpr size_t STRING_OVERSAMPLING = 16;
+
+} // namespace
+
+void multikeyQuickSort(std::vector<std::string_view> &strings) {
+    multikeyRange(strings.data(), strings.size(), 0);
+}
+
+void stringRadixSortMSD(std::vector<std::string_view> &strings) {
+    radixRange(strings.data(), strings.size());
+}
+
+void sortStrings(std::span<std::string_view> strings, StringSortEngine engine) {
+    if (engine == StringSortEngine::MultikeyQuicksort) {
+        multikeyRange(strings.data(), strings.size(), 0);
+    } else {
+        radixRange(strings.data(), strings.size());
+    }
+}
+
+void sortStringsParallel(std::vector<std::string_view> &strings, ThreadPool &pool, StringSortEngine engine) {
+    size_t n = strings.size();
+    size_t workers = pool.size();
+    if (workers <= 1 || n < MIN_PARALLEL_STRINGS) {
+        sortStrings(strings, engine);
+        return;
+    }
+
+    // Splitters: every STRING_OVERSAMPLING-th string of a sorted, evenly spaced sample
+    size_t buckets = workers * STRING_BUCKETS_PER_WORKER;
+    std::vector<std::string_view> sample(buckets * STRING_OVERSAMPLING);
+    for (size_t i = 0; i < sample.size(); i++) {
+        sample[i] = strings[i * n / sample.size()];
+    }
+    sortStrings(sample, engine);
+    std::vector<std::string_view> splitters(buckets - 1);
+    for (size_t b = 0; b + 1 < buckets; b++) {
+        splitters[b] = sample[(b + 1) * STRING_OVERSAMPLING];
+    }
+
+    // Classify per block (equal strings land in one bucket), then scatter
+    // bucket-major, block-minor into a second array of views
+    size_t blocks = workers * STRING_BUCKETS_PER_WORKER;
+    size_t block_size = (n + blocks - 1) / blocks;
+    std::vector<uint16_t> bucket_of(n);
+    std::vector<size_t> offsets(blocks * buckets, 0);
+    std::vector<std::future<void>> futures;
+    auto for_each_block = [&](auto body) {
+        futures.clear();
+        for (size_t block = 0; block < blocks; block++) {
+            size_t begin = std::min(n, block * block_size);
+            size_t end = std::min(n, begin + block_size);
+            futures.push_back(pool.submit([&body, block, begin, end]() { body(block, begin, end); }));
+        }
+        for (auto &fut: futures) {
+            fut.get();
+        }
+    };
+    for_each_block([&](size_t block, size_t begin, size_t end) {
+        size_t *counts = offsets.data() + block * buckets;
+        for (size_t i = begin; i < end; i++) {
+            auto bucket = std::upper_bound(splitters.begin(), splitters.end(), strings[i]) - splitters.begin();
+            bucket_of[i] = static_cast<uint16_t>(bucket);
+            counts[bucket]++;
+        }
+    });
+
+    std::vector<size_t> bucket_bounds(buckets + 1, 0);
+    size_t offset = 0;
+    for (size_t b = 0; b < buckets; b++) {
+        bucket_bounds[b] = offset;
+        for (size_t block = 0; block < blocks; block++) {
+            size_t count = offsets[block * buckets + b];
+            offsets[block * buckets + b] = offset;
+            offset += count;
+        }
+    }
+    bucket_bounds[buckets] = n;
+
+    std::vector<std::string_view> scattered(n);
+    for_each_block([&](size_t block, size_t begin, size_t end) {
+        size_t *next = offsets.data() + block * buckets;
+        for (size_t i = begin; i < end; i++) {
+            scattered[next[bucket_of[i]]++] = strings[i];
+        }
+    });
+
+    futures.clear();
+    for (size_t b = 0; b < buckets; b++) {
+        size_t begin = bucket_bounds[b];
+        size_t length = bucket_bounds[b + 1] - begin;
+        if (length > 1) {
+            futures.push_back(pool.submit([&scattered, begin, length, engine]() {
+                sortStrings(std::span<std::string_view>(scattered.data() + begin, length), engine);
+            }));
+        }
+    }
+    for (auto &fut: futures) {
+        fut.get();
+    }
+    strings.swap(scattered);
+}
@@ -0,0 +1,68 @@
+#ifndef STRING_SORT_H
+#define STRING_SORT_H
+
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <vector>
+
+class ThreadPool;
+
+// Strings stored back to back in one buffer: string i is
+// bytes[offsets[i], offsets[i + 1]). Views taken with operator[] or views()
+// stay valid until the next append().
+class StringArena {
+public:
+    StringArena() : offsets_{0} {}
+
+    void reserve(size_t strings, size_t bytes);
+
+    void append(std::string_view text);
+
+    size_t size() const { return offsets_.size() - 1; }
+
+    size_t bytes() const { return bytes_.size(); }
+
+    std::string_view operator[](size_t i) const {
+        return {bytes_.data() + offsets_[i], offsets_[i + 1] - offsets_[i]};
+    }
+
+    // A view of every string, in arena order: what the string sorts rearrange
+    std::vector<std::string_view> views() const;
+
+private:
+    std::vector<char> bytes_;
+    std::vector<size_t> offsets_;
+};
+
+// Sort engine behind the string sorts
+enum class StringSortEngine {
+    MultikeyQuicksort,    // three-way radix quick sort on one character at a time
+    RadixMSD              // MSD radix sort on cached 8-byte prefixes
+};
+
+// Bentley-Sedgewick multikey quicksort: a three-way partition on the
+// character at the current depth, recursing one character deeper only into
+// the part equal to the pivot character. Strings are compared bytewise as
+// unsigned chars (std::string_view order).
+void multikeyQuickSort(std::vector<std::string_view> &strings);
+
+// MSD radix sort on the next 8 bytes of every string, loaded once per level
+// into a cached big-endian prefix next to the view. The digits are that
+// prefix's bytes, permuted in place (American flag). Strings are only touched
+// again when a group shares all 8 bytes and continues 8 bytes deeper. Small
+// groups are finished by insertion sort.
+void stringRadixSortMSD(std::vector<std::string_view> &strings);
+
+// Either engine on any contiguous range
+void sortStrings(std::span<std::string_view> strings, StringSortEngine engine);
+
+// String sample sort on the pool: splitters from an evenly spaced sample,
+// parallel classification and scatter into one bucket per task, then every
+// bucket sorted with `engine` as its own task. Splitting by sampled strings
+// rather than by leading bytes keeps buckets balanced when all the strings
+// share a long prefix.
+void sortStringsParallel(std::vector<std::string_view> &strings, ThreadPool &pool,
+                         StringSortEngine engine = StringSortEngine::RadixMSD);
+
+#endif // STRING_SORT_H
@@ -0,0 +1,255 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ThreadPool.h"
+
+// ============================================
+// ThreadPool microbenchmarks
+// ============================================
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct PoolBenchmarkConfig {
+    size_t pool_size = 8;
+    size_t tasks = 200000;          // tasks per throughput measurement
+    size_t max_producers = 8;
+    size_t latency_samples = 20000;
+};
+
+double nanosecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+// Print percentiles plus a log2-bucketed histogram of latency samples (ns)
+void printHistogram(const std::string &title, std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&samples](double p) {
+        size_t index = static_cast<size_t>(p * (samples.size() - 1));
+        return samples[index];
+    };
+
+    std::cout << title << " (" << samples.size() << " samples)" << std::endl;
+    std::cout << std::fixed << std::setprecision(0)
+            << "  p50: " << percentile(0.50) << " ns"
+            << "  p90: " << percentile(0.90) << " ns"
+            << "  p99: " << percentile(0.99) << " ns"
+            << "  p99.9: " << percentile(0.999) << " ns"
+            << "  max: " << samples.back() << " ns" << std::endl;
+
+    std::vector<size_t> buckets(40, 0);
+    for (double sample: samples) {
+        size_t bucket = sample < 1.0 ? 0 : static_cast<size_t>(std::log2(sample));
+        buckets[std::min(bucket, buckets.size() - 1)]++;
+    }
+    size_t largest = *std::max_element(buckets.begin(), buckets.end());
+    for (size_t b = 0; b < buckets.size(); b++) {
+        if (buckets[b] == 0) continue;
+        size_t bar = (buckets[b] * 50 + largest - 1) / largest;
+        std::cout << "  [" << std::setw(10) << (1ULL << b) << ", " << std::setw(10) << (1ULL << (b + 1))
+                << ") ns " << std::setw(8) << buckets[b] << " " << std::string(bar, '#') << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+// Empty tasks submitted from 1..max_producers threads; reports completed tasks per second
+void benchmarkThroughput(const PoolBenchmarkConfig &config) {
+    std::cout << "Empty-task throughput" << std::endl;
+    std::cout << "----------------------------------------" << std::endl;
+
+    for (size_t producers = 1; producers <= config.max_producers; producers *= 2) {
+        ThreadPool pool(config.pool_size);
+        size_t per_producer = config.tasks / producers;
+
+        auto start = Clock::now();
+        std::vector<std::thread> threads;
+        for (size_t p = 0; p < producers; p++) {
+            threads.emplace_back([&pool, per_producer]() {
+                std::vector<std::future<void>> futures;
+                futures.reserve(per_producer);
+                for (size_t i = 0; i < per_producer; i++) {
+                    futures.push_back(pool.submit([]() {}));
+                }
+                for (auto &future: futures) {
+                    future.get();
+                }
+            });
+        }
+        for (auto &thread: threads) {
+            thread.join();
+        }
+        double seconds = nanosecondsSince(start) / 1e9;
+
+        double total = static_cast<double>(per_producer * producers);
+        std::cout << "  " << std::setw(3) << producers << " producer(s): "
+                << std::fixed << std::setprecision(0) << total / seconds << " tasks/s, "
+                << std::setprecision(1) << seconds * 1e9 / total << " ns/task" << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+// Time from submit() until the task body starts, with the pool busy (queueing)
+// and with the pool idle between submissions (worker wakeup)
+void benchmarkLatency(const PoolBenchmarkConfig &config) {
+    ThreadPool pool(config.pool_size);
+
+    std::vector<double> queued(config.latency_samples);
+    {
+        std::vector<std::future<void>> futures;
+        futures.reserve(config.latency_samples);
+        for (size_t i = 0; i < config.latency_samples; i++) {
+            auto submitted = Clock::now();
+            futures.push_back(pool.submit([&queued, i, submitted]() {
+                queued[i] = nanosecondsSince(submitted);
+            }));
+        }
+        for (auto &future: futures) {
+            future.get();
+        }
+    }
+    printHistogram("Submit-to-start latency (back-to-back submits)", queued);
+
+    size_t wakeup_samples = std::min<size_t>(config.latency_samples, 2000);
+    std::vector<double> wakeup(wakeup_samples);
+    for (size_t i = 0; i < wakeup_samples; i++) {
+        // Let every worker go back to sleep on the condition variable
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        auto submitted = Clock::now();
+        pool.submit([&wakeup, i, submitted]() {
+            wakeup[i] = nanosecondsSince(submitted);
+        }).get();
+    }
+    printHistogram("Wakeup latency (submit to an idle pool)", wakeup);
+
+    std::vector<double> round_trip(config.latency_samples);
+    for (size_t i = 0; i < config.latency_samples; i++) {
+        auto submitted = Clock::now();
+        pool.submit([]() {}).get();
+        round_trip[i] = nanosecondsSince(submitted);
+    }
+    printHistogram("future.get() round trip", round_trip);
+}
+
+// Submit K tasks and wait for all of them, as the parallel sorts do per pass
+double benchmarkFanOut(const PoolBenchmarkConfig &config) {
+    std::cout << "Fan-out/fan-in barrier cost" << std::endl;
+    std::cout << "----------------------------------------" << std::endl;
+
+    ThreadPool pool(config.pool_size);
+    double per_task_at_largest = 0.0;
+
+    for (size_t task_count = 1; task_count <= 4096; task_count *= 4) {
+        size_t rounds = std::max<size_t>(10, 20000 / task_count);
+        std::vector<std::future<void>> futures;
+        futures.reserve(task_count);
+
+        auto start = Clock::now();
+        for (size_t r = 0; r < rounds; r++) {
+            futures.clear();
+            for (size_t t = 0; t < task_count; t++) {
+                futures.push_back(pool.submit([]() {}));
+            }
+            for (auto &future: futures) {
+                future.get();
+            }
+        }
+        double per_round = nanosecondsSince(start) / rounds;
+        per_task_at_largest = per_round / task_count;
+
+        std::cout << "  " << std::setw(5) << task_count << " tasks: "
+                << std::fixed << std::setprecision(2) << per_round / 1000.0 << " us per fan-out, "
+                << std::setprecision(0) << per_round / task_count << " ns per task" << std::endl;
+    }
+    std::cout << std::endl;
+    return per_task_at_largest;
+}
+
+// Suggest a sort grain where per-task pool overhead stays under 5% of the work
+void suggestChunkSize(double per_task_overhead_ns) {
+    constexpr size_t SAMPLE_SIZE = 2048;
+    constexpr int ROUNDS = 200;
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<> dis(1, 1000000);
+    std::vector<int> data(SAMPLE_SIZE);
+
+    double total_ns = 0.0;
+    for (int r = 0; r < ROUNDS; r++) {
+        for (auto &value: data) {
+            value = dis(gen);
+        }
+        auto start = Clock::now();
+        std::sort(data.begin(), data.end());
+        total_ns += nanosecondsSince(start);
+    }
+    double ns_per_element = total_ns / ROUNDS / SAMPLE_SIZE;
+
+    // Work for a chunk of n elements is roughly ns_per_element * n; overhead <= 5% of that
+    double min_chunk = per_task_overhead_ns / (0.05 * ns_per_element);
+    size_t suggested = 1;
+    while (suggested < min_chunk) {
+        suggested *= 2;
+    }
+
+    std::cout << "Sort grain suggestion" << std::endl;
+    std::cout << "----------------------------------------" << std::endl;
+    std::cout << "  Sort cost: " << std::fixed << std::setprecision(2) << ns_per_element
+            << " ns/element (std::sort, " << SAMPLE_SIZE << " elements)" << std::endl;
+    std::cout << "  Pool overhead: " << std::setprecision(0) << per_task_overhead_ns << " ns/task" << std::endl;
+    std::cout << "  MIN_CHUNK_SIZE >= " << suggested << " keeps overhead under 5%" << std::endl;
+}
+
+bool parseSize(const char *text, size_t &value) {
+    char *end = nullptr;
+    unsigned long long parsed = std::strtoull(text, &end, 10);
+    if (end == text || *end != '\0' || parsed == 0) return false;
+    value = static_cast<size_t>(parsed);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    PoolBenchmarkConfig config;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool ok = i + 1 < argc;
+        if (ok && arg == "--pool-size") ok = parseSize(argv[++i], config.pool_size);
+        else if (ok && arg == "--tasks") ok = parseSize(argv[++i], config.tasks);
+        else if (ok && arg == "--max-producers") ok = parseSize(argv[++i], config.max_producers);
+        else if (ok && arg == "--latency-samples") ok = parseSize(argv[++i], config.latency_samples);
+        else ok = false;
+
+        if (!ok) {
+            std::cerr << "Usage: " << argv[0]
+                    << " [--pool-size N] [--tasks N] [--max-producers N] [--latency-samples N]" << std::endl;
+            return 2;
+        }
+    }
+
+    std::cout << "========================================" << std::endl;
+    std::cout << "THREADPOOL MICROBENCHMARK" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "  Pool size: " << config.pool_size << std::endl;
+    std::cout << "  Hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << "  Tasks per throughput run: " << config.tasks << std::endl;
+    std::cout << "========================================\n" << std::endl;
+
+    benchmarkThroughput(config);
+    benchmarkLatency(config);
+    double per_task = benchmarkFanOut(config);
+    suggestChunkSize(per_task);
+
+    return 0;
+}
@@ -0,0 +1,144 @@
+#include "timer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define SORT_BENCH_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace {
+
+using SteadyClock = std::chrono::steady_clock;
+
+#ifdef SORT_BENCH_X86
+// CPUID 0x80000007 EDX bit 8: the TSC ticks at a constant rate across P-/C-states
+bool hasInvariantTsc() {
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 0x80000000);
+    if (static_cast<unsigned>(regs[0]) < 0x80000007u) return false;
+    __cpuid(regs, 0x80000007);
+    return (regs[3] & (1 << 8)) != 0;
+#else
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000000u, &eax, &ebx, &ecx, &edx) || eax < 0x80000007u) return false;
+    if (!__get_cpuid(0x80000007u, &eax, &ebx, &ecx, &edx)) return false;
+    return (edx & (1u << 8)) != 0;
+#endif
+}
+
+// lfence on both sides keeps the read from drifting into or out of the timed code
+inline uint64_t readTsc() {
+    _mm_lfence();
+    uint64_t tsc = __rdtsc();
+    _mm_lfence();
+    return tsc;
+}
+#endif
+
+uint64_t steadyNanoseconds() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        SteadyClock::now().time_since_epoch()).count());
+}
+
+#ifdef SORT_BENCH_X86
+// Ticks per nanosecond over a ~10 ms window, or 0 if the window was disturbed
+double calibrateTscOnce() {
+    auto wall_start = SteadyClock::now();
+    uint64_t tsc_start = readTsc();
+    while (SteadyClock::now() - wall_start < std::chrono::milliseconds(10)) {
+    }
+    uint64_t tsc_end = readTsc();
+    auto wall_end = SteadyClock::now();
+
+    double wall_ns = std::chrono::duration<double, std::nano>(wall_end - wall_start).count();
+    return wall_ns > 0.0 ? static_cast<double>(tsc_end - tsc_start) / wall_ns : 0.0;
+}
+#endif
+
+} // namespace
+
+const PrecisionTimer &PrecisionTimer::instance() {
+    static const PrecisionTimer timer;
+    return timer;
+}
+
+PrecisionTimer::PrecisionTimer() : use_tsc_(false), ns_per_tick_(1.0), overhead_ns_(0.0) {
+#ifdef SORT_BENCH_X86
+    if (hasInvariantTsc()) {
+        // Three independent windows must agree within 0.5%, otherwise the TSC
+        // is not trustworthy here (e.g. unsynchronised under a hypervisor)
+        std::vector<double> rates;
+        for (int i = 0; i < 3; i++) {
+            rates.push_back(calibrateTscOnce());
+        }
+        std::sort(rates.begin(), rates.end());
+        if (rates.front() > 0.0 && (rates.back() - rates.front()) / rates[1] < 0.005) {
+            use_tsc_ = true;
+            ns_per_tick_ = 1.0 / rates[1];
+        }
+    }
+#endif
+
+    // Overhead: the minimum over many back-to-back reads is the floor every region pays
+    double best = 1e12;
+    for (int i = 0; i < 10000; i++) {
+        uint64_t a = now();
+        uint64_t b = now();
+        best = std::min(best, toNanoseconds(b - a));
+    }
+    overhead_ns_ = best;
+}
+
+uint64_t PrecisionTimer::now() const {
+#ifdef SORT_BENCH_X86
+    if (use_tsc_) {
+        return readTsc();
+    }
+#endif
+    return steadyNanoseconds();
+}
+
+double PrecisionTimer::toNanoseconds(uint64_t ticks) const {
+    return static_cast<double>(ticks) * ns_per_tick_;
+}
+
+double PrecisionTimer::elapsedNanoseconds(uint64_t start, uint64_t end) const {
+    return std::max(0.0, toNanoseconds(end - start) - overhead_ns_);
+}
+
+std::string PrecisionTimer::description() const {
+    std::ostringstream out;
+    if (use_tsc_) {
+        out << "invariant TSC @ " << std::fixed << std::setprecision(3) << 1.0 / ns_per_tick_ << " GHz";
+    } else {
+        out << "steady_clock";
+    }
+    out << ", overhead " << std::fixed << std::setprecision(1) << overhead_ns_ << " ns";
+    return out.str();
+}
+
+std::string formatDuration(double nanoseconds) {
+    std::ostringstream out;
+    out << std::fixed;
+    if (nanoseconds < 1e3) {
+        out << std::setprecision(0) << nanoseconds << " ns";
+    } else if (nanoseconds < 1e6) {
+        out << std::setprecision(2) << nanoseconds / 1e3 << " us";
+    } else if (nanoseconds < 1e9) {
+        out << std::setprecision(2) << nanoseconds / 1e6 << " ms";
+    } else {
+        out << std::setprecision(3) << nanoseconds / 1e9 << " s";
+    }
+    return out.str();
+}
@@ -0,0 +1,44 @@
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <cstdint>
+#include <string>
+
+// Nanosecond-resolution wall clock for timed regions.
+// On x86 with an invariant TSC it reads the time-stamp counter, calibrated at
+// first use against std::chrono::steady_clock; otherwise it falls back to
+// steady_clock. The cost of reading the clock twice is measured once so it can
+// be subtracted from short regions.
+class PrecisionTimer {
+public:
+    static const PrecisionTimer &instance();
+
+    // Current time in timer ticks
+    uint64_t now() const;
+
+    // Convert a tick difference to nanoseconds
+    double toNanoseconds(uint64_t ticks) const;
+
+    // Elapsed nanoseconds between two now() readings, minus the clock's own overhead
+    double elapsedNanoseconds(uint64_t start, uint64_t end) const;
+
+    // Cost of an empty now()/now() pair in nanoseconds
+    double overheadNanoseconds() const { return overhead_ns_; }
+
+    bool usesTsc() const { return use_tsc_; }
+
+    // Human-readable description, e.g. "invariant TSC @ 2.994 GHz, overhead 12 ns"
+    std::string description() const;
+
+private:
+    PrecisionTimer();
+
+    bool use_tsc_;
+    double ns_per_tick_;
+    double overhead_ns_;
+};
+
+// Format a duration with a unit that keeps 3-4 significant digits ("850 ns", "12.34 us", "1.23 ms")
+std::string formatDuration(double nanoseconds);
+
+#endif // TIMER_H
@@ -0,0 +1,132 @@
+#include "verification.h"
+#include <algorithm>
+#include <thread>
+
+namespace {
+
+// Below this many elements a single thread is faster than spawning workers
+constexpr size_t PARALLEL_THRESHOLD = 1 << 20;
+
+// Elements per block in the order check: small enough to exit early on a
+// failure, large enough for the branch-free inner loop to vectorize
+constexpr size_t ORDER_BLOCK = 4096;
+
+size_t verificationThreads(size_t n) {
+    if (n < PARALLEL_THRESHOLD) return 1;
+    size_t hw = std::max(1u, std::thread::hardware_concurrency());
+    return std::min(hw, n / (PARALLEL_THRESHOLD / 4));
+}
+
+// Run body(begin, end) over [0, n) split across worker threads
+template<class Body>
+void parallelRanges(size_t n, Body body) {
+    size_t threads = verificationThreads(n);
+    if (threads <= 1) {
+        body(0, n, 0);
+        return;
+    }
+
+    size_t chunk = (n + threads - 1) / threads;
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (size_t t = 1; t < threads; t++) {
+        size_t begin = std::min(n, t * chunk);
+        size_t end = std::min(n, begin + chunk);
+        workers.emplace_back(body, begin, end, t);
+    }
+    body(0, std::min(n, chunk), 0);
+    for (auto &worker: workers) {
+        worker.join();
+    }
+}
+
+// splitmix64 finaliser: a strong, cheap bijective mix of the key
+inline uint64_t mix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// Keys are hashed by their bit pattern, zero-extended to 64 bits
+inline uint64_t keyBits(int key) { return static_cast<uint32_t>(key); }
+
+inline uint64_t keyBits(int64_t key) { return static_cast<uint64_t>(key); }
+
+template<class T>
+MultisetFingerprint fingerprintRange(const T *data, size_t begin, size_t end) {
+    MultisetFingerprint fp;
+    fp.count = end - begin;
+    for (size_t i = begin; i < end; i++) {
+        uint64_t key = keyBits(data[i]);
+        fp.hash_sum += mix(key);
+        fp.alt_hash_sum += mix(key ^ 0x5bd1e9955bd1e995ULL);
+    }
+    return fp;
+}
+
+// Checks data[begin - 1] <= data[begin] <= ... <= data[end - 1]
+template<class T>
+bool isSortedRange(const T *data, size_t begin, size_t end) {
+    size_t i = std::max<size_t>(begin, 1);
+    while (i < end) {
+        size_t block_end = std::min(end, i + ORDER_BLOCK);
+        unsigned violations = 0;
+        for (size_t j = i; j < block_end; j++) {
+            violations |= static_cast<unsigned>(data[j] < data[j - 1]);
+        }
+        if (violations) return false;
+        i = block_end;
+    }
+    return true;
+}
+
+template<class T>
+MultisetFingerprint fingerprintImpl(const T *data, size_t n) {
+    std::vector<MultisetFingerprint> partial(verificationThreads(n));
+    parallelRanges(n, [data, &partial](size_t begin, size_t end, size_t t) {
+        partial[t] = fingerprintRange(data, begin, end);
+    });
+
+    // Sums modulo 2^64 are order-independent, so per-thread parts just add up
+    MultisetFingerprint total;
+    for (const auto &part: partial) {
+        total += part;
+    }
+    return total;
+}
+
+template<class T>
+bool isSortedParallelImpl(const T *data, size_t n) {
+    std::vector<char> ok(verificationThreads(n), 1);
+    parallelRanges(n, [data, &ok](size_t begin, size_t end, size_t t) {
+        ok[t] = isSortedRange(data, begin, end);
+    });
+    return std::all_of(ok.begin(), ok.end(), [](char v) { return v != 0; });
+}
+
+} // namespace
+
+MultisetFingerprint fingerprint(const int *data, size_t n) {
+    return fingerprintImpl(data, n);
+}
+
+MultisetFingerprint fingerprint(const int64_t *data, size_t n) {
+    return fingerprintImpl(data, n);
+}
+
+bool isSortedParallel(const int *data, size_t n) {
+    return isSortedParallelImpl(data, n);
+}
+
+bool isSortedParallel(const int64_t *data, size_t n) {
+    return isSortedParallelImpl(data, n);
+}
+
+VerificationResult verifySortedPermutation(const MultisetFingerprint &input_fingerprint,
+                                           const std::vector<int> &output) {
+    VerificationResult result;
+    result.is_sorted = isSortedParallel(output.data(), output.size());
+    result.is_permutation = fingerprint(output.data(), output.size()) == input_fingerprint;
+    return result;
+}
@@ -0,0 +1,49 @@
+#ifndef VERIFICATION_H
+#define VERIFICATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Order-independent fingerprint of a multiset of keys: element count plus two
+// sums of independent 64-bit hashes. Dropping, duplicating or altering any
+// element changes it with overwhelming probability.
+struct MultisetFingerprint {
+    uint64_t count = 0;
+    uint64_t hash_sum = 0;
+    uint64_t alt_hash_sum = 0;
+
+    bool operator==(const MultisetFingerprint &other) const = default;
+
+    // Fingerprints of disjoint parts combine into the fingerprint of their union
+    MultisetFingerprint &operator+=(const MultisetFingerprint &other) {
+        count += other.count;
+        hash_sum += other.hash_sum;
+        alt_hash_sum += other.alt_hash_sum;
+        return *this;
+    }
+};
+
+// Outcome of checking a sort's output against its input
+struct VerificationResult {
+    bool is_sorted;
+    bool is_permutation;
+
+    bool passed() const { return is_sorted && is_permutation; }
+};
+
+// Fingerprint of data[0, n); large inputs are hashed on several threads
+MultisetFingerprint fingerprint(const int *data, size_t n);
+
+MultisetFingerprint fingerprint(const int64_t *data, size_t n);
+
+// Non-decreasing order check; large inputs are checked on several threads
+bool isSortedParallel(const int *data, size_t n);
+
+bool isSortedParallel(const int64_t *data, size_t n);
+
+// Check that `output` is sorted and is a permutation of the input that produced `input_fingerprint`
+VerificationResult verifySortedPermutation(const MultisetFingerprint &input_fingerprint,
+                                           const std::vector<int> &output);
+
+#endif // VERIFICATION_H